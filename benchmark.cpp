@@ -0,0 +1,1143 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <cmath>
+#include <limits>
+#include "include/MapParser.h"
+#include "include/Terrain.h"
+#include "include/Optimizer.h"
+#include "include/Parallel.h"
+#include <cstring>
+#include "include/RectPlanner.h"
+#include "include/VisibilityPlanner.h"
+#include "include/TerrainSynthesizer.h"
+#include "include/PyramidPlanner.h"
+#include "include/FlightLevels.h"
+#include "include/StationPlanner.h"
+#include "include/MissionPlanner.h"
+#include "include/FleetAllocator.h"
+
+// UAV Flight Path Optimizer - performance benchmarks
+//
+// Usage: ./uav_benchmark [suite] [args...]
+//   parse [megabytes]   Text map parser throughput in MB/s
+//   layout [sizes...]   findPathAStar on row-major vs Morton layouts and
+//                       full vs packed cell encodings; --full sweeps
+//                       2048 to 16384 (16384 needs about 16 GB)
+//   rects [sizes...]    Grid A* vs rectangle-perimeter search on open maps,
+//                       plus decomposition build and edit cost
+//   visibility [sizes...]  Grid A* vs visibility graph on sparse blocky maps
+//   wind [sizes...]     Directional edge cost build and wind-aware A*
+//   generate [count] [size]  Seeded map corpus throughput and determinism
+//   clearance [sizes...]  Obstacle distance transform and clearance-aware A*
+//   pyramid [sizes...]  Full-resolution A* vs coarse-to-fine corridor search
+//   flight [sizes...]   Ground-level A* vs 3D search over flight levels
+//   energy [sizes...]   Shortest route within a battery budget, from loose
+//                       budgets down to the least-energy route
+//   stations [sizes...] Station graph build (1 thread vs all) and long-range
+//                       routing through recharge stops
+//   pareto [sizes...]   Full and capped distance/energy Pareto fronts vs a
+//                       findEnergyOptimalPath weight sweep
+//   kpaths [sizes...]   Five alternative routes at several diversities,
+//                       spur searches on one thread vs all
+//   mission [count...]  Survey missions over a 1024x1024 map: waypoints
+//                       chained in the given order vs the planned tour
+//   fleet [count...]    Drone-to-target assignment: Hungarian vs auction
+//                       on count x count costs, and whole allocations
+//                       over a 256x256 map
+//   regions [size]      Summed-area region queries vs per-cell loops, and
+//                       table updates after edits
+//   edits [size]        Geofence polygons: per-cell addObstacle vs fillPolygon
+//   noise [sizes...]    Fractal noise synthesis into packed maps (16384 for
+//                       load-test scale) and resulting terrain mix
+
+namespace {
+
+double secondsSince(std::chrono::high_resolution_clock::time_point start) {
+    auto now = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(now - start).count();
+}
+
+// Random text map of roughly the requested size
+std::string makeTextMap(size_t megabytes, int width) {
+    const char symbols[] = {'.', '.', '.', '.', '.', '^', 'O', 'W'};
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> pick(0, sizeof(symbols) - 1);
+
+    size_t rows = megabytes * 1024 * 1024 / (width + 1);
+    std::string text;
+    text.reserve(rows * (width + 1));
+    for (size_t y = 0; y < rows; y++) {
+        for (int x = 0; x < width; x++) {
+            text.push_back(symbols[pick(gen)]);
+        }
+        text.push_back('\n');
+    }
+    return text;
+}
+
+// The line-vector + per-cell setter path the parser used to take
+Terrain parseLegacy(MapParser& parser, const std::string& text) {
+    std::vector<std::string> lines = parser.parseMapLines(text);
+    Terrain terrain(lines[0].length(), lines.size());
+    for (int y = 0; y < terrain.getHeight(); y++) {
+        for (int x = 0; x < terrain.getWidth(); x++) {
+            char c = lines[y][x];
+            TerrainType type = c == '^' ? TerrainType::HILL :
+                               c == 'O' ? TerrainType::OBSTACLE :
+                               c == 'W' ? TerrainType::WIND_ZONE : TerrainType::NORMAL;
+            terrain.setTerrain(x, y, type);
+            if (type == TerrainType::HILL) terrain.setElevation(x, y, 3.0);
+            if (type == TerrainType::WIND_ZONE) terrain.setWindResistance(x, y, 2.0);
+        }
+    }
+    return terrain;
+}
+
+void reportThroughput(const std::string& label, size_t bytes, double seconds) {
+    double mb = bytes / (1024.0 * 1024.0);
+    std::cout << std::left << std::setw(28) << label
+              << std::right << std::fixed << std::setprecision(3) << std::setw(9) << seconds << " s"
+              << std::setprecision(1) << std::setw(10) << mb / seconds << " MB/s\n";
+}
+
+void benchmarkParse(size_t megabytes) {
+    std::cout << "=== Text map parser (" << megabytes << " MB) ===\n";
+    std::string text = makeTextMap(megabytes, 4096);
+    MapParser parser;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    Terrain legacy = parseLegacy(parser, text);
+    reportThroughput("getline + setTerrain", text.size(), secondsSince(start));
+
+    start = std::chrono::high_resolution_clock::now();
+    Terrain single = parser.parseMapBuffer(text.data(), text.size(), 1);
+    reportThroughput("parseMapBuffer (1 thread)", text.size(), secondsSince(start));
+
+    unsigned threads = defaultThreadCount();
+    start = std::chrono::high_resolution_clock::now();
+    Terrain parallel = parser.parseMapBuffer(text.data(), text.size(), threads);
+    reportThroughput("parseMapBuffer (" + std::to_string(threads) + " threads)", text.size(), secondsSince(start));
+
+    bool same = legacy.getHeight() == single.getHeight() && single.getHeight() == parallel.getHeight();
+    for (int y = 0; same && y < single.getHeight(); y += 97) {
+        for (int x = 0; x < single.getWidth(); x++) {
+            if (legacy.getTerrain(x, y) != single.getTerrain(x, y) ||
+                single.getTerrain(x, y) != parallel.getTerrain(x, y)) {
+                same = false;
+                break;
+            }
+        }
+    }
+    std::cout << "Results match: " << (same ? "yes" : "NO") << "\n\n";
+}
+
+void benchmarkLayout(const std::vector<int>& sizes) {
+    std::cout << "=== A* cell layout (corner to corner) ===\n";
+    MapParser parser;
+
+    for (int size : sizes) {
+        Terrain terrain = parser.generateRandomMap(size, size, 0.15, 0.1, 0.1);
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        terrain.setTerrain(start.x, start.y, TerrainType::NORMAL);
+        terrain.setTerrain(goal.x, goal.y, TerrainType::NORMAL);
+
+        // One terrain converted in place between runs, so 16k maps need a
+        // single copy of the layers
+        for (int stage = 0; stage < 3; stage++) {
+            if (stage == 1) terrain.setLayout(CellLayout::MORTON);
+            if (stage == 2) terrain.setEncoding(CellEncoding::PACKED);
+
+            Optimizer optimizer(terrain);
+            optimizer.findPathAStar(start, start); // Allocate the workspace up front
+
+            auto begin = std::chrono::high_resolution_clock::now();
+            std::vector<Point> path = optimizer.findPathAStar(start, goal);
+            double seconds = secondsSince(begin);
+
+            std::cout << std::setw(5) << size << "x" << std::left << std::setw(6) << size
+                      << std::setw(15) << (stage == 0 ? "row-major" : stage == 1 ? "morton" : "morton+packed")
+                      << std::right << std::fixed << std::setprecision(3) << std::setw(9) << seconds << " s"
+                      << std::setw(8) << path.size() << " steps\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+// Cost as the searches account it: entered cell cost times step length
+double searchCost(const Terrain& terrain, const std::vector<Point>& path) {
+    double cost = 0.0;
+    for (size_t i = 1; i < path.size(); i++) {
+        bool diagonal = path[i].x != path[i - 1].x && path[i].y != path[i - 1].y;
+        cost += terrain.getMovementCost(path[i]) * (diagonal ? std::sqrt(2.0) : 1.0);
+    }
+    return cost;
+}
+
+void benchmarkRects(const std::vector<int>& sizes) {
+    std::cout << "=== Rectangular decomposition (corner to corner, open map) ===\n";
+    std::mt19937 gen(42);
+
+    for (int size : sizes) {
+        // Mostly open map with scattered 8x8 obstacle blocks
+        Terrain terrain(size, size);
+        std::uniform_int_distribution<int> pick(0, size - 9);
+        for (int block = 0; block < size / 10; block++) {
+            int bx = pick(gen), by = pick(gen);
+            for (int y = by; y < by + 8; y++) {
+                for (int x = bx; x < bx + 8; x++) {
+                    terrain.setTerrain(x, y, TerrainType::OBSTACLE);
+                }
+            }
+        }
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        terrain.setTerrain(start.x, start.y, TerrainType::NORMAL);
+        terrain.setTerrain(goal.x, goal.y, TerrainType::NORMAL);
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        RectDecomposition decomposition(terrain);
+        double buildSeconds = secondsSince(begin);
+
+        Optimizer optimizer(terrain);
+        RectPlanner planner(decomposition);
+        optimizer.findPathAStar(start, start);
+        planner.findPath(start, start);
+
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> gridPath = optimizer.findPathAStar(start, goal);
+        double gridSeconds = secondsSince(begin);
+
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> rectPath = planner.findPath(start, goal);
+        double rectSeconds = secondsSince(begin);
+        double gridCost = searchCost(terrain, gridPath);
+        double rectCost = searchCost(terrain, rectPath);
+
+        begin = std::chrono::high_resolution_clock::now();
+        const int edits = 1000;
+        for (int i = 0; i < edits; i++) {
+            terrain.setTerrain(pick(gen), pick(gen), i % 2 ? TerrainType::HILL : TerrainType::NORMAL);
+        }
+        double editSeconds = secondsSince(begin);
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << size << "x" << size << ": " << decomposition.rectCount() << " rectangles, built in "
+                  << buildSeconds << " s, " << edits << " edits in " << editSeconds << " s\n"
+                  << "  grid A*          " << std::setw(9) << gridSeconds << " s  cost "
+                  << gridCost << "\n"
+                  << "  rect perimeters  " << std::setw(9) << rectSeconds << " s  cost "
+                  << rectCost << "  (" << planner.getExpandedNodes()
+                  << " expansions)\n";
+    }
+    std::cout << "\n";
+}
+
+void benchmarkVisibility(const std::vector<int>& sizes) {
+    std::cout << "=== Visibility graph (corner to corner, sparse blocks) ===\n";
+    std::mt19937 gen(7);
+
+    for (int size : sizes) {
+        // Uniform-cost map with a few large rectangular obstacles, kept
+        // off the border so the corners stay connected
+        Terrain terrain(size, size);
+        std::uniform_int_distribution<int> extent(size / 100 + 1, size / 20 + 2);
+        for (int block = 0; block < 100; block++) {
+            int bw = extent(gen), bh = extent(gen);
+            int bx = std::uniform_int_distribution<int>(1, size - bw - 2)(gen);
+            int by = std::uniform_int_distribution<int>(1, size - bh - 2)(gen);
+            for (int y = by; y < by + bh; y++) {
+                for (int x = bx; x < bx + bw; x++) {
+                    terrain.setTerrain(x, y, TerrainType::OBSTACLE);
+                }
+            }
+        }
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        terrain.setTerrain(start.x, start.y, TerrainType::NORMAL);
+        terrain.setTerrain(goal.x, goal.y, TerrainType::NORMAL);
+
+        VisibilityPlanner planner(terrain);
+        auto begin = std::chrono::high_resolution_clock::now();
+        size_t corners = planner.cornerCount();
+        double buildSeconds = secondsSince(begin);
+
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> waypoints = planner.findPath(start, goal);
+        double querySeconds = secondsSince(begin);
+
+        Optimizer optimizer(terrain);
+        optimizer.findPathAStar(start, start);
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> gridPath = optimizer.findPathAStar(start, goal);
+        double gridSeconds = secondsSince(begin);
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << size << "x" << size << ": " << corners << " corners, " << planner.edgeCount()
+                  << " edges, built in " << buildSeconds << " s\n"
+                  << "  grid A*          " << std::setw(9) << gridSeconds << " s  cost "
+                  << searchCost(terrain, gridPath) << "\n"
+                  << "  visibility graph " << std::setw(9) << querySeconds << " s  cost "
+                  << planner.getLastPathCost() << "  (" << waypoints.size() << " waypoints)\n";
+    }
+    std::cout << "\n";
+}
+
+void benchmarkWind(const std::vector<int>& sizes) {
+    std::cout << "=== Wind vector field (corner to corner) ===\n";
+    MapParser parser;
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> gust(-0.5f, 0.5f);
+
+    for (int size : sizes) {
+        Terrain terrain = parser.generateRandomMap(size, size, 0.15, 0.1, 0.1);
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        terrain.setTerrain(start.x, start.y, TerrainType::NORMAL);
+        terrain.setTerrain(goal.x, goal.y, TerrainType::NORMAL);
+
+        // Steady westerly with per-cell gusts
+        std::vector<WindVector> field(static_cast<size_t>(size) * size);
+        for (WindVector& wind : field) {
+            wind = WindVector{2.0f + gust(gen), gust(gen)};
+        }
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        terrain.setWindField(field.data());
+        double buildSeconds = secondsSince(begin);
+
+        Optimizer optimizer(terrain);
+        optimizer.findPathAStar(start, start);
+
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> plain = optimizer.findPathAStar(start, goal);
+        double plainSeconds = secondsSince(begin);
+
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> windy = optimizer.findWindOptimalPath(start, goal);
+        double windSeconds = secondsSince(begin);
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << size << "x" << size << ": edge costs built in " << buildSeconds << " s\n"
+                  << "  findPathAStar       " << std::setw(9) << plainSeconds << " s" << std::setw(8) << plain.size() << " steps\n"
+                  << "  findWindOptimalPath " << std::setw(9) << windSeconds << " s" << std::setw(8) << windy.size() << " steps\n";
+    }
+    std::cout << "\n";
+}
+
+void benchmarkGenerate(size_t count, int size) {
+    std::cout << "=== Seeded map generation ===\n";
+    MapParser parser;
+    unsigned threads = defaultThreadCount();
+
+    // Corpus: one map per seed, maps spread across threads
+    std::vector<size_t> obstacles(count, 0);
+    auto begin = std::chrono::high_resolution_clock::now();
+    parallelFor(0, count, threads, [&](size_t first, size_t last, unsigned) {
+        for (size_t seed = first; seed < last; seed++) {
+            Terrain terrain(size, size);
+            terrain.generateRandomTerrain(0.2, 0.1, 0.1, seed, 1);
+            const TerrainType* types = terrain.terrainData();
+            for (size_t i = 0; i < terrain.cellCount(); i++) {
+                obstacles[seed] += types[i] == TerrainType::OBSTACLE;
+            }
+        }
+    });
+    double seconds = secondsSince(begin);
+    std::cout << count << " maps of " << size << "x" << size << " in " << std::fixed << std::setprecision(3)
+              << seconds << " s (" << std::setprecision(0) << count / seconds << " maps/s, "
+              << threads << " threads)\n";
+
+    // One large map: thread count must not change a single bit
+    const int large = 2048;
+    Terrain serial(large, large);
+    begin = std::chrono::high_resolution_clock::now();
+    serial.generateRandomTerrain(0.2, 0.1, 0.1, 12345, 1);
+    double serialSeconds = secondsSince(begin);
+
+    unsigned split = std::max(4u, threads); // Split rows even on small machines
+    Terrain parallel(large, large);
+    begin = std::chrono::high_resolution_clock::now();
+    parallel.generateRandomTerrain(0.2, 0.1, 0.1, 12345, split);
+    double parallelSeconds = secondsSince(begin);
+
+    size_t cells = serial.cellCount();
+    bool same = std::memcmp(serial.terrainData(), parallel.terrainData(), cells * sizeof(TerrainType)) == 0 &&
+                std::memcmp(serial.elevationData(), parallel.elevationData(), cells * sizeof(double)) == 0 &&
+                std::memcmp(serial.windData(), parallel.windData(), cells * sizeof(double)) == 0;
+    std::cout << large << "x" << large << ": 1 thread " << std::setprecision(3) << serialSeconds << " s, "
+              << split << " threads " << parallelSeconds << " s, identical: " << (same ? "yes" : "NO") << "\n\n";
+}
+
+void benchmarkClearance(const std::vector<int>& sizes) {
+    std::cout << "=== Obstacle clearance (corner to corner) ===\n";
+    // Scattered obstacle blobs with open ground between them
+    NoiseSettings settings;
+    settings.featureSize = 48.0;
+    settings.obstacleLevel = 0.74;
+    TerrainSynthesizer synthesizer(settings);
+
+    for (int size : sizes) {
+        Terrain terrain = synthesizer.generate(size, size, 99);
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        TerrainBrush open = TerrainBrush().withType(TerrainType::NORMAL);
+        terrain.fillCircle(start, 4.0, open);
+        terrain.fillCircle(goal, 4.0, open);
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        ClearanceField clearance(terrain);
+        double buildSeconds = secondsSince(begin);
+
+        Optimizer optimizer(terrain);
+        optimizer.findPathAStar(start, start);
+
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> plain = optimizer.findPathAStar(start, goal);
+        double plainSeconds = secondsSince(begin);
+
+        ClearanceOptions options;
+        options.minClearance = 2.0;
+        options.penaltyRadius = 5.0;
+        options.penaltyWeight = 1.0;
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> safe = optimizer.findClearancePath(start, goal, clearance, options);
+        double safeSeconds = secondsSince(begin);
+
+        auto closest = [&](const std::vector<Point>& path) {
+            float nearest = std::numeric_limits<float>::infinity();
+            for (const Point& p : path) nearest = std::min(nearest, clearance.getClearance(p.x, p.y));
+            return nearest;
+        };
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << size << "x" << size << ": distance transform in " << buildSeconds << " s\n"
+                  << "  findPathAStar     " << std::setw(9) << plainSeconds << " s" << std::setw(8) << plain.size()
+                  << " steps, closest obstacle " << std::setprecision(2) << closest(plain) << "\n" << std::setprecision(3)
+                  << "  findClearancePath " << std::setw(9) << safeSeconds << " s" << std::setw(8) << safe.size()
+                  << " steps, closest obstacle " << std::setprecision(2) << closest(safe) << "\n";
+    }
+    std::cout << "\n";
+}
+
+void benchmarkPyramid(const std::vector<int>& sizes) {
+    std::cout << "=== Coarse-to-fine planning (corner to corner) ===\n";
+    TerrainSynthesizer synthesizer;
+
+    for (int size : sizes) {
+        Terrain terrain = synthesizer.generate(size, size, 7);
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        TerrainBrush open = TerrainBrush().withType(TerrainType::NORMAL);
+        terrain.fillCircle(start, 4.0, open);
+        terrain.fillCircle(goal, 4.0, open);
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        CostPyramid pyramid(terrain);
+        double buildSeconds = secondsSince(begin);
+
+        // One edit, then the incremental update it causes
+        terrain.fillRect(size / 2, size / 2, size / 2 + 31, size / 2 + 31, TerrainBrush().withType(TerrainType::HILL));
+        begin = std::chrono::high_resolution_clock::now();
+        pyramid.refresh();
+        double updateSeconds = secondsSince(begin);
+
+        Optimizer optimizer(terrain);
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> exact = optimizer.findPathAStar(start, goal);
+        double exactSeconds = secondsSince(begin);
+
+        std::cout << std::fixed << std::setprecision(4) << size << "x" << size << ": " << pyramid.levelCount()
+                  << " levels built in " << buildSeconds << " s, 32x32 edit updated in " << updateSeconds << " s\n"
+                  << "  findPathAStar      " << std::setw(9) << exactSeconds << " s, cost "
+                  << std::setprecision(1) << searchCost(terrain, exact) << "\n";
+
+        for (int finest : {0, 2, 4}) {
+            PyramidOptions options;
+            options.finestLevel = finest;
+            PyramidPlanner planner(pyramid, options);
+            planner.findPath(start, goal); // Warm up the workspace
+
+            begin = std::chrono::high_resolution_clock::now();
+            std::vector<Point> route = planner.findPath(start, goal);
+            double seconds = secondsSince(begin);
+
+            std::cout << std::setprecision(4) << "  pyramid, level " << finest << "   " << std::setw(9) << seconds << " s, ";
+            if (finest == 0) {
+                std::cout << "cost " << std::setprecision(1) << searchCost(terrain, route);
+            } else {
+                std::cout << route.size() << " block waypoints";
+            }
+            std::cout << ", " << planner.getExpandedNodes() << " nodes\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+void benchmarkFlight(const std::vector<int>& sizes) {
+    std::cout << "=== Flight levels (corner to corner) ===\n";
+    TerrainSynthesizer synthesizer;
+
+    for (int size : sizes) {
+        Terrain terrain = synthesizer.generate(size, size, 7);
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        TerrainBrush open = TerrainBrush().withType(TerrainType::NORMAL).withElevation(0.0);
+        terrain.fillCircle(start, 4.0, open);
+        terrain.fillCircle(goal, 4.0, open);
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        FlightLevels levels(terrain);
+        double buildSeconds = secondsSince(begin);
+
+        Optimizer optimizer(terrain);
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> ground = optimizer.findPathAStar(start, goal);
+        double groundSeconds = secondsSince(begin);
+
+        begin = std::chrono::high_resolution_clock::now();
+        std::vector<FlightPoint> route = optimizer.findFlightPath(start, goal, levels);
+        double flightSeconds = secondsSince(begin);
+
+        int highest = 0;
+        for (const FlightPoint& p : route) {
+            highest = std::max(highest, p.level);
+        }
+
+        std::cout << std::fixed << std::setprecision(4) << size << "x" << size << ": " << levels.levelCount()
+                  << " levels in " << levels.memoryBytes() / 1024 << " KiB, built in " << buildSeconds << " s\n"
+                  << "  findPathAStar   " << std::setw(9) << groundSeconds << " s" << std::setw(8) << ground.size()
+                  << " steps, cost " << std::setprecision(1) << searchCost(terrain, ground) << "\n"
+                  << std::setprecision(4)
+                  << "  findFlightPath  " << std::setw(9) << flightSeconds << " s" << std::setw(8) << route.size()
+                  << " steps, highest level " << highest << "\n";
+    }
+    std::cout << "\n";
+}
+
+void benchmarkEnergy(const std::vector<int>& sizes) {
+    std::cout << "=== Energy-constrained routing (corner to corner) ===\n";
+    TerrainSynthesizer synthesizer;
+
+    auto length = [](const std::vector<Point>& path) {
+        double total = 0.0;
+        for (size_t i = 1; i < path.size(); i++) {
+            total += std::hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+        }
+        return total;
+    };
+
+    for (int size : sizes) {
+        Terrain terrain = synthesizer.generate(size, size, 7);
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        TerrainBrush open = TerrainBrush().withType(TerrainType::NORMAL);
+        terrain.fillCircle(start, 4.0, open);
+        terrain.fillCircle(goal, 4.0, open);
+
+        Optimizer optimizer(terrain);
+        auto begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> cheapest = optimizer.findPathAStar(start, goal);
+        double cheapestSeconds = secondsSince(begin);
+        double leastEnergy = optimizer.calculatePathEnergy(cheapest);
+
+        std::cout << std::fixed << std::setprecision(4) << size << "x" << size << ": findPathAStar in "
+                  << cheapestSeconds << " s, least energy " << std::setprecision(1) << leastEnergy
+                  << ", length " << length(cheapest) << "\n";
+
+        for (double slack : {2.0, 1.25, 1.05, 0.99}) {
+            begin = std::chrono::high_resolution_clock::now();
+            std::vector<Point> route = optimizer.findEnergyConstrainedPath(start, goal, leastEnergy * slack);
+            double seconds = secondsSince(begin);
+
+            std::cout << std::setprecision(2) << "  budget x" << slack << std::setprecision(4)
+                      << std::setw(10) << seconds << " s, ";
+            if (route.empty()) {
+                std::cout << "no route within budget\n";
+            } else {
+                std::cout << std::setprecision(1) << "energy " << optimizer.calculatePathEnergy(route)
+                          << ", length " << length(route) << "\n";
+            }
+        }
+    }
+    std::cout << "\n";
+}
+
+void benchmarkStations(const std::vector<int>& sizes) {
+    std::cout << "=== Recharge-station routing (corner to corner) ===\n";
+    TerrainSynthesizer synthesizer;
+    const double range = 300.0;
+
+    for (int size : sizes) {
+        Terrain terrain = synthesizer.generate(size, size, 7);
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        TerrainBrush open = TerrainBrush().withType(TerrainType::NORMAL);
+        terrain.fillCircle(start, 4.0, open);
+        terrain.fillCircle(goal, 4.0, open);
+
+        // Roughly one station per 64x64 block, on free cells
+        std::mt19937 gen(17);
+        std::uniform_int_distribution<int> pick(0, size - 1);
+        terrain.beginBatch();
+        for (int i = 0; i < (size / 64) * (size / 64); i++) {
+            Point p(pick(gen), pick(gen));
+            if (!terrain.isObstacle(p)) terrain.addEnergyStation(p);
+        }
+        terrain.endBatch();
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        StationPlanner serial(terrain, range, 1);
+        double serialSeconds = secondsSince(begin);
+
+        begin = std::chrono::high_resolution_clock::now();
+        StationPlanner planner(terrain, range);
+        double parallelSeconds = secondsSince(begin);
+
+        begin = std::chrono::high_resolution_clock::now();
+        StationRoute route = planner.findRoute(start, goal, range);
+        double querySeconds = secondsSince(begin);
+
+        std::cout << std::fixed << std::setprecision(4) << size << "x" << size << ": "
+                  << planner.getStations().size() << " stations, " << planner.linkCount()
+                  << " links within " << std::setprecision(0) << range << " energy\n" << std::setprecision(4)
+                  << "  graph build, 1 thread  " << std::setw(9) << serialSeconds << " s\n"
+                  << "  graph build, " << std::setw(2) << defaultThreadCount() << " threads " << std::setw(9)
+                  << parallelSeconds << " s\n"
+                  << "  findRoute              " << std::setw(9) << querySeconds << " s, ";
+        if (route.path.empty()) {
+            std::cout << "unreachable\n";
+        } else {
+            std::cout << route.stops.size() << " stops, " << route.path.size() << " steps, energy "
+                      << std::setprecision(1) << route.energy << "\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+void benchmarkPareto(const std::vector<int>& sizes) {
+    std::cout << "=== Distance/energy Pareto fronts (corner to corner) ===\n";
+    TerrainSynthesizer synthesizer;
+
+    for (int size : sizes) {
+        Terrain terrain = synthesizer.generate(size, size, 7);
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        TerrainBrush open = TerrainBrush().withType(TerrainType::NORMAL);
+        terrain.fillCircle(start, 4.0, open);
+        terrain.fillCircle(goal, 4.0, open);
+        Optimizer optimizer(terrain);
+
+        // What ops did before: one search per weight (node-allocating
+        // search, so only on small maps)
+        const int weights = 10;
+        std::cout << std::fixed << std::setprecision(4) << size << "x" << size << ": ";
+        auto begin = std::chrono::high_resolution_clock::now();
+        if (size <= 512) {
+            for (int i = 0; i < weights; i++) {
+                optimizer.findEnergyOptimalPath(start, goal, 0.5 + 0.25 * i);
+            }
+            std::cout << weights << " findEnergyOptimalPath weights in " << secondsSince(begin) << " s\n";
+        } else {
+            std::cout << "weight sweep skipped above 512x512\n";
+        }
+
+        for (size_t cap : {static_cast<size_t>(0), static_cast<size_t>(8)}) {
+            begin = std::chrono::high_resolution_clock::now();
+            std::vector<ParetoPath> front = optimizer.findParetoPaths(start, goal, cap);
+            double seconds = secondsSince(begin);
+
+            std::cout << std::setprecision(4) << "  findParetoPaths, cap " << cap << std::setw(9) << seconds << " s, "
+                      << front.size() << " routes";
+            if (!front.empty()) {
+                std::cout << std::setprecision(1) << ", length " << front.front().distance << " -> "
+                          << front.back().distance << ", energy " << front.front().energy << " -> "
+                          << front.back().energy;
+            }
+            std::cout << "\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+void benchmarkKPaths(const std::vector<int>& sizes) {
+    std::cout << "=== Alternative routes, k = 5 (corner to corner) ===\n";
+    TerrainSynthesizer synthesizer;
+
+    for (int size : sizes) {
+        Terrain terrain = synthesizer.generate(size, size, 7);
+        Point start(0, 0);
+        Point goal(size - 1, size - 1);
+        TerrainBrush open = TerrainBrush().withType(TerrainType::NORMAL);
+        terrain.fillCircle(start, 4.0, open);
+        terrain.fillCircle(goal, 4.0, open);
+        Optimizer optimizer(terrain);
+
+        std::cout << std::fixed << std::setprecision(4) << size << "x" << size << ":\n";
+        auto begin = std::chrono::high_resolution_clock::now();
+        double bestEnergy = optimizer.calculatePathEnergy(optimizer.findPathAStar(start, goal));
+        std::cout << "  findPathAStar, one route     " << std::setw(9) << secondsSince(begin) << " s\n";
+
+        for (double diversity : {0.0, 0.3, 0.6}) {
+            for (unsigned threads : {1u, defaultThreadCount()}) {
+                begin = std::chrono::high_resolution_clock::now();
+                std::vector<std::vector<Point>> routes = optimizer.findKPaths(start, goal, 5, diversity, threads);
+                double seconds = secondsSince(begin);
+
+                std::cout << std::setprecision(1) << "  diversity " << diversity << ", " << std::setw(2) << threads
+                          << " threads " << std::setprecision(4) << std::setw(9) << seconds << " s, "
+                          << routes.size() << " routes";
+                if (!routes.empty() && bestEnergy > 0.0) {
+                    double worst = optimizer.calculatePathEnergy(routes.back());
+                    std::cout << std::setprecision(1) << ", last +" << 100.0 * (worst / bestEnergy - 1.0) << "% energy";
+                }
+                std::cout << "\n";
+            }
+        }
+    }
+    std::cout << "\n";
+}
+
+void benchmarkMission(const std::vector<int>& counts) {
+    std::cout << "=== Survey missions (1024x1024, waypoints in a 256x256 area) ===\n";
+    TerrainSynthesizer synthesizer;
+    const int size = 1024;
+    Terrain terrain = synthesizer.generate(size, size, 7);
+    Point base(400, 400);
+    TerrainBrush open = TerrainBrush().withType(TerrainType::NORMAL);
+    terrain.fillCircle(base, 4.0, open);
+    Optimizer optimizer(terrain);
+
+    for (int count : counts) {
+        // Free waypoints reachable from base, in the order they were drawn
+        std::mt19937 gen(23);
+        std::uniform_int_distribution<int> pick(300, 555);
+        std::vector<Point> waypoints;
+        while (static_cast<int>(waypoints.size()) < count) {
+            Point p(pick(gen), pick(gen));
+            if (terrain.isPassable(p) && !optimizer.findPathAStar(base, p).empty()) waypoints.push_back(p);
+        }
+
+        // What ops did before: one findPath per leg, in the given order
+        auto begin = std::chrono::high_resolution_clock::now();
+        std::vector<Point> chained(1, base);
+        Point at = base;
+        for (size_t i = 0; i <= waypoints.size(); i++) {
+            Point next = i < waypoints.size() ? waypoints[i] : base;
+            std::vector<Point> leg = optimizer.findPath(at, next);
+            chained.insert(chained.end(), leg.begin() + 1, leg.end());
+            at = next;
+        }
+        double chainedSeconds = secondsSince(begin);
+        double chainedEnergy = optimizer.calculatePathEnergy(chained);
+
+        std::cout << std::fixed << std::setprecision(4) << count << " waypoints:\n"
+                  << "  chained findPath       " << std::setw(9) << chainedSeconds << " s, energy "
+                  << std::setprecision(1) << chainedEnergy << "\n";
+        for (unsigned threads : {1u, defaultThreadCount()}) {
+            MissionPlanner planner(terrain, threads);
+            begin = std::chrono::high_resolution_clock::now();
+            MissionPlan plan = planner.plan(base, waypoints);
+            double seconds = secondsSince(begin);
+            std::cout << std::setprecision(4) << "  plan, " << std::setw(2) << threads << " threads      "
+                      << std::setw(9) << seconds << " s, energy " << std::setprecision(1) << plan.energy << "\n";
+        }
+
+        // A battery that covers about a third of the tour per sortie, and
+        // every waypoint's round trip
+        MissionPlanner planner(terrain);
+        std::vector<Point> stops(1, base);
+        stops.insert(stops.end(), waypoints.begin(), waypoints.end());
+        std::vector<std::vector<double>> matrix = planner.costMatrix(stops, stops);
+        MissionOptions limited;
+        limited.energyCapacity = optimizer.calculatePathEnergy(planner.plan(base, waypoints).path) / 3.0;
+        for (size_t i = 1; i < stops.size(); i++) {
+            limited.energyCapacity = std::max(limited.energyCapacity, matrix[0][i] + matrix[i][0]);
+        }
+        begin = std::chrono::high_resolution_clock::now();
+        MissionPlan plan = planner.plan(base, waypoints, limited);
+        double seconds = secondsSince(begin);
+        std::cout << std::setprecision(4) << "  plan, capacity " << std::setprecision(1) << limited.energyCapacity
+                  << std::setprecision(4) << std::setw(9) << seconds << " s, ";
+        if (plan.path.empty()) {
+            std::cout << "infeasible\n";
+        } else {
+            std::cout << plan.sorties.size() << " sorties, energy " << std::setprecision(1) << plan.energy << "\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+void benchmarkFleet(const std::vector<int>& counts) {
+    std::cout << "=== Fleet task allocation ===\n";
+    TerrainSynthesizer synthesizer;
+    const int size = 256;
+    Terrain terrain = synthesizer.generate(size, size, 11);
+
+    for (int count : counts) {
+        std::mt19937 gen(31);
+        std::uniform_real_distribution<double> coordinate(0.0, size);
+        std::uniform_real_distribution<double> roughness(1.0, 1.5);
+        std::vector<double> droneX(count), droneY(count), targetX(count), targetY(count);
+        for (int i = 0; i < count; i++) {
+            droneX[i] = coordinate(gen);
+            droneY[i] = coordinate(gen);
+            targetX[i] = coordinate(gen);
+            targetY[i] = coordinate(gen);
+        }
+
+        // Distances roughened per pair, and i * j, the Hungarian
+        // algorithm's cubic worst case
+        std::vector<std::vector<double>> geometric(count, std::vector<double>(count));
+        std::vector<std::vector<double>> product(count, std::vector<double>(count));
+        for (int i = 0; i < count; i++) {
+            for (int j = 0; j < count; j++) {
+                geometric[i][j] = std::hypot(droneX[i] - targetX[j], droneY[i] - targetY[j]) * roughness(gen);
+                product[i][j] = static_cast<double>(i) * j;
+            }
+        }
+
+        std::cout << count << " x " << count << ":\n";
+        for (int kind = 0; kind < 2; kind++) {
+            const std::vector<std::vector<double>>& costs = kind == 0 ? geometric : product;
+            auto begin = std::chrono::high_resolution_clock::now();
+            FleetAssignment hungarian = FleetAllocator::solveHungarian(costs);
+            double hungarianSeconds = secondsSince(begin);
+            begin = std::chrono::high_resolution_clock::now();
+            FleetAssignment auction = FleetAllocator::solveAuction(costs);
+            double auctionSeconds = secondsSince(begin);
+            std::cout << std::fixed << std::setprecision(4) << (kind == 0 ? "  distances" : "  i * j    ")
+                      << "  Hungarian " << std::setw(8) << hungarianSeconds << " s, auction " << std::setw(8)
+                      << auctionSeconds << " s, cost " << std::setprecision(1) << hungarian.cost << " vs "
+                      << auction.cost << "\n";
+        }
+
+        // Drones and targets on free cells of the map
+        std::uniform_int_distribution<int> pick(0, size - 1);
+        std::vector<Point> drones, targets;
+        while (static_cast<int>(targets.size()) < count) {
+            Point p(pick(gen), pick(gen));
+            if (!terrain.isPassable(p)) continue;
+            if (drones.size() < targets.size()) {
+                drones.push_back(p);
+            } else {
+                targets.push_back(p);
+            }
+        }
+        for (unsigned threads : {1u, defaultThreadCount()}) {
+            FleetAllocator allocator(terrain, threads);
+            auto begin = std::chrono::high_resolution_clock::now();
+            FleetAssignment assignment = allocator.allocate(drones, targets);
+            double seconds = secondsSince(begin);
+            size_t assigned = 0;
+            for (size_t target : assignment.targetOf) {
+                if (target != FleetAllocator::NO_ASSIGNMENT) assigned++;
+            }
+            std::cout << std::setprecision(4) << "  allocate, " << std::setw(2) << threads << " threads "
+                      << std::setw(8) << seconds << " s, " << assigned << " assigned, energy "
+                      << std::setprecision(1) << assignment.cost << "\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+void benchmarkRegions(int size) {
+    std::cout << "=== Region cost queries ===\n";
+    MapParser parser;
+    Terrain terrain = parser.generateRandomMap(size, size, 0.15, 0.1, 0.1);
+    
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> corner(0, size - 65);
+    std::uniform_int_distribution<int> extent(16, 64);
+    struct Box { int x0, y0, x1, y1; };
+    std::vector<Box> boxes(20000);
+    for (Box& box : boxes) {
+        box.x0 = corner(gen);
+        box.y0 = corner(gen);
+        box.x1 = box.x0 + extent(gen);
+        box.y1 = box.y0 + extent(gen);
+    }
+    
+    auto begin = std::chrono::high_resolution_clock::now();
+    terrain.refreshRegionSums();
+    double buildSeconds = secondsSince(begin);
+    
+    double loopTotal = 0.0;
+    begin = std::chrono::high_resolution_clock::now();
+    for (const Box& box : boxes) {
+        for (int y = box.y0; y <= box.y1; y++) {
+            for (int x = box.x0; x <= box.x1; x++) {
+                loopTotal += terrain.getMovementCost(Point(x, y));
+            }
+        }
+    }
+    double loopSeconds = secondsSince(begin);
+    
+    double tableTotal = 0.0;
+    begin = std::chrono::high_resolution_clock::now();
+    for (const Box& box : boxes) {
+        tableTotal += terrain.regionCost(box.x0, box.y0, box.x1, box.y1);
+    }
+    double tableSeconds = secondsSince(begin);
+    
+    // An edit near the far corner only dirties the entries below and right of it
+    terrain.setTerrain(size - 10, size - 10, TerrainType::OBSTACLE);
+    begin = std::chrono::high_resolution_clock::now();
+    terrain.refreshRegionSums();
+    double cornerSeconds = secondsSince(begin);
+    
+    terrain.setTerrain(size / 2, size / 2, TerrainType::OBSTACLE);
+    begin = std::chrono::high_resolution_clock::now();
+    terrain.refreshRegionSums();
+    double centreSeconds = secondsSince(begin);
+    
+    std::cout << size << "x" << size << ", " << boxes.size() << " boxes: tables built in " << std::fixed
+              << std::setprecision(4) << buildSeconds << " s\n"
+              << "  per-cell loop " << loopSeconds << " s, regionCost " << std::setprecision(6) << tableSeconds
+              << " s, relative difference " << std::scientific << std::setprecision(1)
+              << std::abs(tableTotal - loopTotal) / loopTotal << "\n" << std::fixed << std::setprecision(4)
+              << "  update after edit: far corner " << cornerSeconds << " s, centre " << centreSeconds << " s\n\n";
+}
+
+void benchmarkEdits(int size) {
+    std::cout << "=== Bulk terrain edits ===\n";
+    
+    // Regular-ish polygons scattered over the map, like projected geofences
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(0.0, size);
+    std::vector<std::vector<Terrain::Vertex>> fences(200);
+    for (auto& fence : fences) {
+        double cx = coord(rng), cy = coord(rng), radius = size / 40.0;
+        for (int k = 0; k < 12; k++) {
+            double angle = k * 2.0 * M_PI / 12;
+            double r = radius * (0.6 + 0.4 * ((k * 7) % 5) / 4.0);
+            fence.push_back(Terrain::Vertex{cx + r * std::cos(angle), cy + r * std::sin(angle)});
+        }
+    }
+    
+    // Baseline: one addObstacle per covered cell (cells listed up front)
+    std::vector<Point> covered;
+    {
+        Terrain mask(size, size);
+        for (const auto& fence : fences) {
+            mask.fillPolygon(fence, TerrainBrush().withType(TerrainType::OBSTACLE));
+        }
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                if (mask.getTerrain(x, y) == TerrainType::OBSTACLE) covered.push_back(Point(x, y));
+            }
+        }
+    }
+    Terrain perCell(size, size);
+    Terrain bulk(size, size);
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (const Point& cell : covered) {
+        perCell.addObstacle(cell);
+    }
+    double perCellSeconds = secondsSince(begin);
+    
+    uint64_t version = bulk.getVersion();
+    begin = std::chrono::high_resolution_clock::now();
+    bulk.beginBatch();
+    for (const auto& fence : fences) {
+        bulk.fillPolygon(fence, TerrainBrush().withType(TerrainType::OBSTACLE));
+    }
+    bulk.endBatch();
+    double bulkSeconds = secondsSince(begin);
+    
+    bool same = std::memcmp(perCell.terrainData(), bulk.terrainData(), bulk.cellCount() * sizeof(TerrainType)) == 0;
+    std::cout << size << "x" << size << ", " << fences.size() << " polygons, " << covered.size() << " cells: "
+              << std::fixed << std::setprecision(4) << "per-cell " << perCellSeconds << " s, fillPolygon "
+              << bulkSeconds << " s (" << std::setprecision(1) << perCellSeconds / bulkSeconds << "x), "
+              << bulk.getVersion() - version << " version bump, identical: " << (same ? "yes" : "NO") << "\n\n";
+}
+
+void benchmarkNoise(const std::vector<int>& sizes) {
+    std::cout << "=== Noise terrain synthesis ===\n";
+    TerrainSynthesizer synthesizer;
+    unsigned threads = defaultThreadCount();
+
+    for (int size : sizes) {
+        Terrain terrain(size, size, CostProfile(), CellEncoding::PACKED);
+        auto begin = std::chrono::high_resolution_clock::now();
+        synthesizer.fill(terrain, 20240601, threads);
+        double seconds = secondsSince(begin);
+
+        size_t counts[4] = {0, 0, 0, 0};
+        size_t cells = terrain.cellCount();
+        for (size_t i = 0; i < cells; i++) {
+            TerrainType type = terrain.cellType(i);
+            if (static_cast<size_t>(type) < 4) counts[static_cast<size_t>(type)]++;
+        }
+        std::cout << size << "x" << size << ": " << std::fixed << std::setprecision(3) << seconds << " s ("
+                  << std::setprecision(1) << cells / seconds / 1e6 << " Mcells/s, " << threads << " threads), "
+                  << "hill " << 100.0 * counts[1] / cells << "%, obstacle " << 100.0 * counts[2] / cells
+                  << "%, wind " << 100.0 * counts[3] / cells << "%\n";
+    }
+    std::cout << "\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string suite = argc > 1 ? argv[1] : "all";
+
+    if (suite == "parse" || suite == "all") {
+        size_t megabytes = argc > 2 && suite == "parse" ? std::stoul(argv[2]) : 64;
+        benchmarkParse(megabytes);
+    }
+
+    if (suite == "layout" || suite == "all") {
+        std::vector<int> sizes;
+        bool full = false;
+        for (int i = 2; suite == "layout" && i < argc; i++) {
+            if (std::strcmp(argv[i], "--full") == 0) {
+                full = true;
+            } else {
+                sizes.push_back(std::stoi(argv[i]));
+            }
+        }
+        if (sizes.empty()) sizes = {2048, 4096};
+        if (full) sizes = {2048, 4096, 8192, 16384};
+        benchmarkLayout(sizes);
+    }
+
+    if (suite == "rects" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "rects" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {1024, 4096};
+        benchmarkRects(sizes);
+    }
+
+    if (suite == "visibility" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "visibility" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {1024, 4096};
+        benchmarkVisibility(sizes);
+    }
+
+    if (suite == "wind" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "wind" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {1024, 2048};
+        benchmarkWind(sizes);
+    }
+
+    if (suite == "generate" || suite == "all") {
+        size_t count = argc > 2 && suite == "generate" ? std::stoul(argv[2]) : 10000;
+        int size = argc > 3 && suite == "generate" ? std::stoi(argv[3]) : 64;
+        benchmarkGenerate(count, size);
+    }
+
+    if (suite == "clearance" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "clearance" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {512, 2048};
+        benchmarkClearance(sizes);
+    }
+
+    if (suite == "pyramid" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "pyramid" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {1024, 4096};
+        benchmarkPyramid(sizes);
+    }
+
+    if (suite == "flight" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "flight" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {512, 2048};
+        benchmarkFlight(sizes);
+    }
+
+    if (suite == "energy" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "energy" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {256, 1024};
+        benchmarkEnergy(sizes);
+    }
+
+    if (suite == "stations" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "stations" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {1024, 2048};
+        benchmarkStations(sizes);
+    }
+
+    if (suite == "pareto" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "pareto" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {256, 1024};
+        benchmarkPareto(sizes);
+    }
+
+    if (suite == "kpaths" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "kpaths" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {256, 1024};
+        benchmarkKPaths(sizes);
+    }
+
+    if (suite == "mission" || suite == "all") {
+        std::vector<int> counts;
+        for (int i = 2; suite == "mission" && i < argc; i++) {
+            counts.push_back(std::stoi(argv[i]));
+        }
+        if (counts.empty()) counts = {20, 100};
+        benchmarkMission(counts);
+    }
+
+    if (suite == "fleet" || suite == "all") {
+        std::vector<int> counts;
+        for (int i = 2; suite == "fleet" && i < argc; i++) {
+            counts.push_back(std::stoi(argv[i]));
+        }
+        if (counts.empty()) counts = {100, 1000};
+        benchmarkFleet(counts);
+    }
+
+    if (suite == "regions" || suite == "all") {
+        int size = argc > 2 && suite == "regions" ? std::stoi(argv[2]) : 4096;
+        benchmarkRegions(size);
+    }
+
+    if (suite == "edits" || suite == "all") {
+        int size = argc > 2 && suite == "edits" ? std::stoi(argv[2]) : 4096;
+        benchmarkEdits(size);
+    }
+
+    if (suite == "noise" || suite == "all") {
+        std::vector<int> sizes;
+        for (int i = 2; suite == "noise" && i < argc; i++) {
+            sizes.push_back(std::stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {4096};
+        benchmarkNoise(sizes);
+    }
+
+    return 0;
+}
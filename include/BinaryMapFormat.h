@@ -0,0 +1,94 @@
+#ifndef BINARY_MAP_FORMAT_H
+#define BINARY_MAP_FORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// Binary .uavmap layout (host byte order, checked through endianTag):
+//
+//   [UavMapHeader, 128 bytes (64 bytes in version 1)]
+//   [type layer:      width*height uint8_t  (TerrainType), row-major]
+//   [elevation layer: width*height double, row-major]
+//   [wind layer:      width*height double, row-major]
+//   [cost layer:      width*height double, row-major]   (version 2+)
+//
+// Every layer starts on a UAVMAP_ALIGNMENT boundary so it can be used in
+// place straight from a memory mapping. The cost layer is only reused when
+// costFingerprint matches the active CostProfile; otherwise it is rebuilt.
+
+static const char UAVMAP_MAGIC[8] = {'U', 'A', 'V', 'M', 'A', 'P', '\0', '\0'};
+static constexpr uint32_t UAVMAP_VERSION = 2;
+static constexpr uint32_t UAVMAP_ENDIAN_TAG = 0x01020304;
+static constexpr size_t UAVMAP_ALIGNMENT = 64;
+static constexpr uint32_t UAVMAP_V1_HEADER_SIZE = 64;
+
+struct UavMapHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t endianTag;
+    uint32_t width;
+    uint32_t height;
+    uint32_t flags;
+    uint64_t typeOffset;
+    uint64_t elevationOffset;
+    uint64_t windOffset;
+    uint64_t costOffset;        // Zero (reserved) in version 1
+    // Version 2 fields
+    uint64_t costFingerprint;
+    double minCellCost;
+    uint64_t reserved[6];
+};
+
+static_assert(sizeof(UavMapHeader) == 128, "UavMapHeader must stay 128 bytes");
+
+inline uint64_t alignMapOffset(uint64_t offset) {
+    return (offset + UAVMAP_ALIGNMENT - 1) & ~static_cast<uint64_t>(UAVMAP_ALIGNMENT - 1);
+}
+
+// Fill in magic, version and layer offsets for a width x height map
+inline UavMapHeader makeUavMapHeader(uint32_t width, uint32_t height, uint32_t version = UAVMAP_VERSION) {
+    UavMapHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, UAVMAP_MAGIC, sizeof(header.magic));
+    header.version = version;
+    header.headerSize = version == 1 ? UAVMAP_V1_HEADER_SIZE : sizeof(UavMapHeader);
+    header.endianTag = UAVMAP_ENDIAN_TAG;
+    header.width = width;
+    header.height = height;
+
+    uint64_t cells = static_cast<uint64_t>(width) * height;
+    header.typeOffset = alignMapOffset(header.headerSize);
+    header.elevationOffset = alignMapOffset(header.typeOffset + cells * sizeof(uint8_t));
+    header.windOffset = alignMapOffset(header.elevationOffset + cells * sizeof(double));
+    if (version >= 2) {
+        header.costOffset = alignMapOffset(header.windOffset + cells * sizeof(double));
+    }
+    return header;
+}
+
+inline bool hasUavMapMagic(const char* data, size_t size) {
+    return size >= sizeof(UAVMAP_MAGIC) && std::memcmp(data, UAVMAP_MAGIC, sizeof(UAVMAP_MAGIC)) == 0;
+}
+
+// Run-length compressed .uavrle layout (varints are LEB128, doubles are
+// host byte order):
+//
+//   magic[8] "UAVRLE\0\0", uint32 version, uint32 width, uint32 height
+//   per row:   varint runCount, then runCount x (uint8 type, varint length)
+//   elevation: varint count, then count x (varint cellDelta, double value)
+//   wind:      varint count, then count x (varint cellDelta, double value)
+//
+// The sparse lists only hold cells whose value differs from the default the
+// text format implies for their type; cellDelta is the row-major index
+// distance from the previous entry.
+
+static const char UAVRLE_MAGIC[8] = {'U', 'A', 'V', 'R', 'L', 'E', '\0', '\0'};
+static constexpr uint32_t UAVRLE_VERSION = 1;
+
+inline bool hasUavRleMagic(const char* data, size_t size) {
+    return size >= sizeof(UAVRLE_MAGIC) && std::memcmp(data, UAVRLE_MAGIC, sizeof(UAVRLE_MAGIC)) == 0;
+}
+
+#endif
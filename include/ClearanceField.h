@@ -0,0 +1,56 @@
+#ifndef CLEARANCE_FIELD_H
+#define CLEARANCE_FIELD_H
+
+#include <vector>
+#include <cstdint>
+#include "Terrain.h"
+
+// Euclidean distance from every cell to the nearest obstacle, in cells
+// between cell centres: obstacles are 0, a free cell beside one is 1, a
+// diagonal neighbour sqrt(2). Cells on an obstacle-free map have +infinity;
+// the map border is not an obstacle.
+//
+// Computed exactly in linear time with Meijster's two-pass transform: a
+// column pass that sweeps whole rows at a time (contiguous, so the
+// compiler vectorizes it) and a per-row lower-envelope pass, each split
+// across threads. The field listens for terrain edits and recomputes on
+// the next refresh() after any change.
+class ClearanceField : public TerrainListener {
+private:
+    const Terrain& terrain;
+    std::vector<float> distance;  // Indexed by Terrain::cellIndex
+    std::vector<uint8_t> blocked; // Row-major obstacle mask (scratch)
+    std::vector<int32_t> column;  // Row-major distance to the nearest obstacle in the column (scratch)
+    uint64_t version;             // Terrain version the field matches
+    bool built;
+    unsigned threads;
+
+    void build();
+
+public:
+    // threads = 0 picks a default for large maps
+    explicit ClearanceField(const Terrain& terrainRef, unsigned threadCount = 0);
+    ~ClearanceField();
+
+    ClearanceField(const ClearanceField&) = delete;
+    ClearanceField& operator=(const ClearanceField&) = delete;
+
+    // Recompute if the terrain changed since the last build
+    void refresh();
+    bool isCurrent() const { return built && version == terrain.getVersion(); }
+
+    // TerrainListener: edits only mark the field stale
+    void onTerrainChanged(int x0, int y0, int x1, int y1) override;
+
+    const Terrain& getTerrain() const { return terrain; }
+
+    // Lookups need a current field (see refresh())
+    float clearanceAt(size_t cell) const { return distance[cell]; }
+    float getClearance(int x, int y) const {
+        if (x < 0 || y < 0 || x >= terrain.getWidth() || y >= terrain.getHeight()) return 0.0f;
+        return distance[terrain.cellIndex(x, y)];
+    }
+    const float* data() const { return distance.data(); }
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef COST_PYRAMID_H
+#define COST_PYRAMID_H
+
+#include <vector>
+#include "Terrain.h"
+
+// One pyramid level: cell (x, y) of level k covers the 2^k x 2^k block of
+// terrain cells starting at (x << k, y << k), clipped to the map
+struct PyramidLevel {
+    int width, height;
+    std::vector<float> minCost; // Cheapest passable cell, +infinity if all blocked
+    std::vector<float> maxCost; // Dearest cell, +infinity if any cell is blocked
+
+    size_t cell(int x, int y) const { return static_cast<size_t>(y) * width + x; }
+};
+
+// Mipmap-style pyramid over a terrain's movement costs. Each level halves
+// the resolution of the one below (rounding up) and keeps the min and max
+// of its children, so a block's bounds are conservative for every cell in
+// it. Level 0 is the terrain itself and is not stored; stored levels go
+// up to the first one whose larger side is at most topSize.
+//
+// Levels are reduced two rows at a time with an SSE2 min/max kernel where
+// available. The pyramid listens for terrain edits, and refresh() re-reduces
+// only the blocks above the edited box.
+class CostPyramid : public TerrainListener {
+private:
+    const Terrain& terrain;
+    int topSize;
+    std::vector<PyramidLevel> levels; // levels[k - 1] is level k
+
+    bool stale;
+    int dirtyX0, dirtyY0, dirtyX1, dirtyY1; // Inclusive, in terrain cells
+
+    // Re-reduce the level-k blocks in rows [y0, y1], columns [x0, x1]
+    void reduceLevel(int k, int x0, int y0, int x1, int y1);
+    // Level-0 costs (obstacles as +infinity) of one terrain row segment
+    void readCosts(int y, int x0, int x1, float* out) const;
+
+public:
+    explicit CostPyramid(const Terrain& terrainRef, int topLevelSize = 32);
+    ~CostPyramid();
+
+    CostPyramid(const CostPyramid&) = delete;
+    CostPyramid& operator=(const CostPyramid&) = delete;
+
+    // Reallocate and reduce every level
+    void rebuild();
+    // Bring the levels up to date with the edits seen since the last update
+    void refresh();
+    bool isCurrent() const { return !stale; }
+
+    // TerrainListener: grow the dirty box
+    void onTerrainChanged(int x0, int y0, int x1, int y1) override;
+
+    const Terrain& getTerrain() const { return terrain; }
+
+    // Number of levels including level 0; level(k) requires 1 <= k < levelCount()
+    int levelCount() const { return static_cast<int>(levels.size()) + 1; }
+    const PyramidLevel& level(int k) const { return levels[k - 1]; }
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <cstdint>
+
+// Counter-based random numbers: every value is a pure function of
+// (seed, stream, counter), so any slice of a generated map (a row, a tile)
+// can be produced on any thread, in any order, with bit-identical results.
+// The mixing function is the SplitMix64 finalizer applied to a Weyl
+// sequence keyed by seed and stream.
+class CounterRng {
+private:
+    uint64_t key;
+    uint64_t counter;
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    static constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    CounterRng(uint64_t seed, uint64_t stream, uint64_t start = 0)
+        : key(mix(seed + GOLDEN_GAMMA) ^ mix(stream * GOLDEN_GAMMA + 0x632BE59BD9B4E019ULL)),
+          counter(start) {}
+
+    // Value at an explicit position in the stream
+    uint64_t at(uint64_t position) const {
+        return mix(key + (position + 1) * GOLDEN_GAMMA);
+    }
+
+    // Sequential draws
+    uint64_t next() { return at(counter++); }
+    void seek(uint64_t position) { counter = position; }
+
+    // Uniform double in [0, 1) from the top 53 bits
+    double nextDouble() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+#endif
@@ -21,6 +21,7 @@ private:
     Point position;
     double maxEnergy;
     double currentEnergy;
+    double reserveFraction; // Share of maxEnergy kept back for landing
     std::vector<Point> flightPath;
     
 public:
@@ -37,6 +38,12 @@ public:
     void resetEnergy();
     bool hasEnergy(double required) const;
     
+    // Reserve margin, as a fraction of maxEnergy in [0, 1]; planners may
+    // only spend getUsableEnergy() = currentEnergy - reserve
+    void setReserveFraction(double fraction);
+    double getReserveFraction() const;
+    double getUsableEnergy() const;
+    
     // Flight path management
     void addToPath(const Point& point);
     std::vector<Point> getFlightPath() const;
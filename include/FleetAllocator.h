@@ -0,0 +1,57 @@
+#ifndef FLEET_ALLOCATOR_H
+#define FLEET_ALLOCATOR_H
+
+#include <vector>
+#include <cstdint>
+#include "Terrain.h"
+#include "Drone.h"
+
+// One target per drone, as returned by FleetAllocator
+struct FleetAssignment {
+    std::vector<size_t> targetOf; // Per drone, its target or FleetAllocator::NO_ASSIGNMENT
+    std::vector<size_t> droneOf;  // Per target, its drone or FleetAllocator::NO_ASSIGNMENT
+    double cost = 0.0;            // Total over the assigned pairs
+};
+
+// Sends a fleet of drones to a set of targets, one target per drone, at
+// the least total energy (the metric of Optimizer::calculatePathEnergy).
+// With more drones than targets some drones stay idle, and the other way
+// round some targets stay unserved; unreachable pairs are never assigned,
+// and as many pairs as possible are.
+//
+// The drone-to-target energies come from MissionPlanner::costMatrix: one
+// search per point on the smaller side, spread across threads. The
+// assignment is then the Hungarian algorithm, exact in O(n^2 m) for n x m
+// costs with n <= m, or for square problems past HUNGARIAN_LIMIT a
+// Gauss-Seidel auction with epsilon scaling. The auction stops once its
+// result is within a millionth of the dearest finite pair cost of the
+// optimum; it settles 1000 x 1000 in about a tenth of a second, where
+// the Hungarian algorithm can need seconds on unlucky costs.
+class FleetAllocator {
+private:
+    const Terrain& terrain;
+    unsigned threads;
+
+public:
+    static constexpr size_t NO_ASSIGNMENT = SIZE_MAX;
+    // Largest square problem solve() still hands to the Hungarian algorithm
+    static constexpr size_t HUNGARIAN_LIMIT = 256;
+
+    // threads = 0 picks a default
+    explicit FleetAllocator(const Terrain& terrainRef, unsigned threadCount = 0);
+
+    const Terrain& getTerrain() const { return terrain; }
+
+    FleetAssignment allocate(const std::vector<Point>& drones, const std::vector<Point>& targets) const;
+    // Same from the drones' positions; a drone is only sent where it can
+    // fly on its usable energy (current energy less its reserve)
+    FleetAssignment allocate(const std::vector<Drone>& drones, const std::vector<Point>& targets) const;
+
+    // Least-cost assignment of rows (drones) to columns (targets);
+    // infinite costs mark pairs that may not be assigned
+    static FleetAssignment solve(const std::vector<std::vector<double>>& costs);
+    static FleetAssignment solveHungarian(const std::vector<std::vector<double>>& costs);
+    static FleetAssignment solveAuction(const std::vector<std::vector<double>>& costs);
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef FLIGHT_LEVELS_H
+#define FLIGHT_LEVELS_H
+
+#include <vector>
+#include <cstdint>
+#include "Terrain.h"
+
+// Discrete altitude model: flight level l is at altitude l * levelHeight
+// above the map datum, in elevation units
+struct FlightLevelSettings {
+    int levelCount = 8;       // Levels 0 .. levelCount - 1 (at most 255)
+    double levelHeight = 1.0;
+    double clearance = 0.5;   // Required height above the ground at every level
+    double climbCost = 2.0;   // Per level climbed
+    double descendCost = 0.5; // Per level descended
+};
+
+// A state of the 3D search: a cell and the flight level above it
+struct FlightPoint {
+    int x, y, level;
+
+    FlightPoint(int px = 0, int py = 0, int pl = 0) : x(px), y(py), level(pl) {}
+    bool operator==(const FlightPoint& other) const {
+        return x == other.x && y == other.y && level == other.level;
+    }
+};
+
+// Free airspace per terrain column. The ground (elevation plus clearance)
+// blocks every level below some floor and nothing above it, so each column
+// is a single run [floor, levelCount) and is stored as one byte, whatever
+// the number of levels; obstacles block the whole column. Columns follow
+// terrain edits as they happen.
+//
+// Flying at altitude, a cell costs its terrain type and wind terms without
+// the elevation term, and HILL cells cost like NORMAL ones: the climb
+// needed to clear them is charged explicitly instead.
+class FlightLevels : public TerrainListener {
+private:
+    const Terrain& terrain;
+    FlightLevelSettings settings;
+    std::vector<uint8_t> floors; // Indexed by Terrain::cellIndex
+    double minAirRate;           // Lower bound on airRate over free cells
+
+    void updateColumns(int x0, int y0, int x1, int y1);
+
+public:
+    FlightLevels(const Terrain& terrainRef, const FlightLevelSettings& levelSettings = FlightLevelSettings());
+    ~FlightLevels();
+
+    FlightLevels(const FlightLevels&) = delete;
+    FlightLevels& operator=(const FlightLevels&) = delete;
+
+    // TerrainListener: recompute the columns in the edited box
+    void onTerrainChanged(int x0, int y0, int x1, int y1) override;
+
+    const Terrain& getTerrain() const { return terrain; }
+    const FlightLevelSettings& getSettings() const { return settings; }
+    int levelCount() const { return settings.levelCount; }
+
+    // Lowest free level of a column; levelCount() when it is fully blocked
+    int floorAt(size_t cell) const { return floors[cell]; }
+    int getFloor(int x, int y) const;
+    bool isFree(int x, int y, int level) const {
+        return level >= 0 && level < settings.levelCount && getFloor(x, y) <= level;
+    }
+
+    // Cost per unit distance of flying through a cell above the ground
+    double airRate(int x, int y) const;
+    double getMinAirRate() const { return minAirRate; }
+
+    // Bytes used by the column store
+    size_t memoryBytes() const { return floors.size() * sizeof(uint8_t); }
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef JSON_CONFIG_H
+#define JSON_CONFIG_H
+
+#include <string>
+#include <map>
+#include <cstdint>
+
+// Minimal JSON reader for config.json. Nested objects are flattened into
+// dotted keys ("terrain_costs.hill_cost") and array elements into indexed
+// keys ("alternative_algorithms[0]"); every scalar is kept as its text.
+class JsonConfig {
+private:
+    std::map<std::string, std::string> values;
+
+    // Recursive descent over the document text
+    void parseValue(const std::string& text, size_t& pos, const std::string& key);
+    std::string parseString(const std::string& text, size_t& pos) const;
+    void skipWhitespace(const std::string& text, size_t& pos) const;
+
+public:
+    JsonConfig();
+
+    // Throws std::runtime_error on malformed JSON
+    void parse(const std::string& text);
+    bool loadFile(const std::string& filename);
+
+    bool has(const std::string& key) const;
+    double getNumber(const std::string& key, double defaultValue) const;
+    // Exact for the full 64-bit range, e.g. seeds
+    uint64_t getUnsigned(const std::string& key, uint64_t defaultValue) const;
+    std::string getString(const std::string& key, const std::string& defaultValue) const;
+    bool getBool(const std::string& key, bool defaultValue) const;
+
+    const std::map<std::string, std::string>& entries() const { return values; }
+};
+
+#endif
@@ -6,15 +6,39 @@
 #include <fstream>
 #include <sstream>
 #include "Terrain.h"
+#include "QuadTerrain.h"
+#include "JsonConfig.h"
 
 class MapParser {
 private:
+    // Parsed config.json and the cost model every loaded map is baked with
+    JsonConfig config;
+    CostProfile costProfile;
+    
+    // Seed for generateRandomMap, from map_generation.seed when configured
+    uint64_t generationSeed;
+    bool hasGenerationSeed;
+    
     // Helper methods for parsing
     TerrainType charToTerrainType(char c) const;
     char terrainTypeToChar(TerrainType type) const;
     
+    // 256-entry decode tables used by the fast text parser
+    TerrainType typeTable[256];
+    double elevationTable[256];
+    double windTable[256];
+    void buildDecodeTables();
+    double defaultElevation(TerrainType type) const;
+    double defaultWindResistance(TerrainType type) const;
+    void decodeRow(const char* row, Terrain& terrain, int y) const;
+    
+    // Shared chunked reader behind the streaming loaders
+    template <typename Reader>
+    Terrain streamRows(Reader read, int heightHint) const;
+    
     // File validation
     bool isValidMapFile(const std::string& filename) const;
+    bool isBinaryMapFile(const std::string& filename) const;
     
 public:
     MapParser();
@@ -22,17 +46,56 @@ public:
     // Map loading methods
     Terrain loadMap(const std::string& filename);
     Terrain loadMapFromString(const std::string& mapData);
+    Terrain loadBinary(const std::string& filename);
+    
+    // Single-pass text parser over a raw buffer; threads = 0 picks a count
+    // automatically and only large buffers are split across threads
+    Terrain parseMapBuffer(const char* data, size_t size, unsigned threads = 0) const;
+    
+    // Streaming loaders: rows are decoded as they arrive, so the read
+    // buffers stay O(row width) and the height need not be known. Without
+    // a heightHint the layers grow by doubling, so the terrain can briefly
+    // take about twice its final size before the spare capacity is
+    // trimmed at the end. A heightHint lets it be allocated once up front.
+    Terrain loadMapStream(std::istream& input, int heightHint = 0) const;
+    Terrain loadMapFromFd(int fd, int heightHint = 0) const;
+    
+    // Quadtree store straight from a map file. Text maps are decoded row
+    // by row into QuadTerrain's bands, so no flat grid is ever built;
+    // binary maps are read in place from their mapping. Compressed maps
+    // are decoded to a Terrain first. quantum as in QuadTerrain.
+    QuadTerrain loadQuadTerrain(const std::string& filename, double quantum = 0.0) const;
     
     // Map saving methods
     bool saveMap(const Terrain& terrain, const std::string& filename) const;
     std::string terrainToString(const Terrain& terrain) const;
+    bool saveBinary(const Terrain& terrain, const std::string& filename) const;
+    bool convertToBinary(const std::string& textFile, const std::string& binaryFile);
+    
+    // Run-length compressed maps (.uavrle) for sparse obstacle layouts
+    std::string encodeCompressed(const Terrain& terrain) const;
+    Terrain decodeCompressed(const char* data, size_t size) const;
+    bool saveCompressed(const Terrain& terrain, const std::string& filename) const;
+    Terrain loadCompressed(const std::string& filename) const;
     
-    // Configuration loading
-    bool loadConfiguration(const std::string& configFile);
+    // Configuration loading. A missing or invalid file (bad JSON, a value
+    // of the wrong kind, a cost that is not finite and positive) prints a
+    // warning and returns false, keeping the current costs and seed.
+    bool loadConfiguration(const std::string& configFile, bool verbose = true);
+    // Throws std::runtime_error on non-numeric values, costs that are not
+    // finite and positive, and factors that are not finite or are negative
+    CostProfile loadCostProfile(const JsonConfig& settings) const;
+    const JsonConfig& getConfiguration() const { return config; }
+    const CostProfile& getCostProfile() const { return costProfile; }
+    void setCostProfile(const CostProfile& profile) { costProfile = profile; }
     
-    // Map generation
+    // Map generation. Without an explicit seed the configured one is used,
+    // or a random one when none is set; a given seed always yields the same map.
     Terrain generateRandomMap(int width, int height, double obstacleRatio = 0.2, 
                              double hillRatio = 0.1, double windRatio = 0.1);
+    Terrain generateRandomMap(int width, int height, double obstacleRatio,
+                             double hillRatio, double windRatio, uint64_t seed);
+    void setGenerationSeed(uint64_t seed) { generationSeed = seed; hasGenerationSeed = true; }
     
     // Utility methods
     std::vector<std::string> parseMapLines(const std::string& content) const;
@@ -0,0 +1,31 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+#include <vector>
+
+// Read-only view of a file mapped into memory. The mapping is private
+// (copy-on-write), so callers may modify the bytes without touching the
+// file on disk.
+class MappedFile {
+private:
+    char* base;
+    size_t length;
+#ifdef _WIN32
+    std::vector<char> buffer; // Fallback: plain read on platforms without mmap
+#endif
+
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    char* data() { return base; }
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+};
+
+#endif
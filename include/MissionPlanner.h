@@ -0,0 +1,82 @@
+#ifndef MISSION_PLANNER_H
+#define MISSION_PLANNER_H
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include "Terrain.h"
+#include "Drone.h"
+#include "Optimizer.h"
+
+// How MissionPlanner::plan may fly a mission
+struct MissionOptions {
+    bool returnToBase = true; // End the mission back at base
+    double energyCapacity = std::numeric_limits<double>::infinity(); // Energy per sortie, from a full charge at base
+};
+
+// Survey mission through a set of waypoints, as returned by MissionPlanner
+struct MissionPlan {
+    std::vector<std::vector<size_t>> sorties; // Waypoint indices per flight from base, in visiting order
+    std::vector<Point> path;                  // Cell by cell from base; empty when infeasible
+    double energy = 0.0;                      // As Optimizer::calculatePathEnergy over the path
+};
+
+// Orders survey waypoints into a mission. Energy is the metric of
+// Optimizer::calculatePathEnergy, which is not symmetric: a leg and its
+// reverse enter different cells.
+//
+// A plan runs one search per waypoint (and the base) out to the others,
+// spread across threads with one reused workspace each. Every search is a
+// Dijkstra inside the waypoints' bounding box, is drawn towards the box
+// from outside, and stops once all targets are settled. The visiting order
+// comes from nearest insertion, then 2-opt and Or-opt moves until neither
+// improves the tour. With an energy capacity the tour is then cut into
+// sorties, returning to base to recharge, at the cheapest feasible cut
+// points for that order. Each leg is finally an A* route, so the path
+// costs what the matrix predicted.
+class MissionPlanner {
+private:
+    const Terrain& terrain;
+    unsigned threads;
+
+    // Targets of one cost matrix. firstTarget holds the first target of
+    // each cell and nextTarget chains the rest.
+    struct TargetSet {
+        std::vector<uint32_t> firstTarget;
+        std::vector<uint32_t> nextTarget;
+        size_t cells = 0; // Cells holding a target
+        Point low, high;  // Bounding box of the targets
+    };
+
+    // Least energy from (forward) or to (!forward) origin for every
+    // target, into costs (left alone when unreachable). Searches in order
+    // of energy plus the cheapest possible flight to the targets' bounding
+    // box, and stops once every target cell is settled.
+    void reachTargets(const Point& origin, const TargetSet& targets, bool forward, SearchWorkspace& ws,
+                      std::vector<double>& costs) const;
+
+public:
+    static constexpr uint32_t NO_TARGET = UINT32_MAX;
+
+    // threads = 0 picks a default
+    explicit MissionPlanner(const Terrain& terrainRef, unsigned threadCount = 0);
+
+    const Terrain& getTerrain() const { return terrain; }
+
+    // Least energy from each source to each target, one row per source
+    // (infinity when unreachable). Runs one search per point on the
+    // smaller side, backward from the targets when they are fewer.
+    std::vector<std::vector<double>> costMatrix(const std::vector<Point>& sources,
+                                                const std::vector<Point>& targets) const;
+
+    // Mission from base through every waypoint. Empty (no path) when a
+    // waypoint cannot be reached, or when a capacity is set and some
+    // waypoint's round trip from base exceeds it.
+    MissionPlan plan(const Point& base, const std::vector<Point>& waypoints,
+                     const MissionOptions& options = MissionOptions()) const;
+    // Same, returning to base whenever the drone's capacity less its
+    // reserve would run out; it recharges fully at base
+    MissionPlan plan(const Point& base, const std::vector<Point>& waypoints, const Drone& drone) const;
+};
+
+#endif
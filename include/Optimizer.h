@@ -3,10 +3,15 @@
 
 #include <vector>
 #include <queue>
+#include <algorithm>
 #include <unordered_map>
 #include <functional>
+#include <cstdint>
 #include "Terrain.h"
 #include "Drone.h"
+#include "WindForecast.h"
+#include "ClearanceField.h"
+#include "FlightLevels.h"
 
 struct PathNode {
     Point position;
@@ -29,14 +34,109 @@ struct PathNodeComparator {
     }
 };
 
+// Open-list entry for the index-based searches
+struct OpenEntry {
+    double fCost;
+    double hCost;
+    int x, y;
+};
+
+struct OpenEntryComparator {
+    bool operator()(const OpenEntry& a, const OpenEntry& b) const {
+        if (a.fCost != b.fCost) {
+            return a.fCost > b.fCost; // Lower fCost has higher priority
+        }
+        return a.hCost > b.hCost; // If fCost is equal, prefer lower hCost
+    }
+};
+
+// Per-cell search state indexed by Terrain::cellIndex, so it follows the
+// terrain's cell layout. It is reused across searches: a generation stamp
+// marks the entries that belong to the current search, so nothing is
+// cleared between runs.
+struct SearchWorkspace {
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+    
+    std::vector<double> gScore;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> stamp;
+    std::vector<OpenEntry> openList; // Binary heap ordered by OpenEntryComparator
+    uint32_t generation = 0;
+    
+    // Start a new search over a terrain with the given number of cells
+    void prepare(size_t cells);
+    
+    bool seen(size_t cell) const { return stamp[cell] == generation; }
+    
+    void visit(size_t cell, double g, uint32_t parentCell) {
+        stamp[cell] = generation;
+        gScore[cell] = g;
+        parent[cell] = parentCell;
+    }
+    
+    void push(const OpenEntry& entry) {
+        openList.push_back(entry);
+        std::push_heap(openList.begin(), openList.end(), OpenEntryComparator());
+    }
+    
+    OpenEntry pop() {
+        std::pop_heap(openList.begin(), openList.end(), OpenEntryComparator());
+        OpenEntry top = openList.back();
+        openList.pop_back();
+        return top;
+    }
+};
+
+// Obstacle clearance requirements for Optimizer::findClearancePath, in
+// ClearanceField units (a free cell beside an obstacle has clearance 1)
+struct ClearanceOptions {
+    double minClearance = 0.0;  // Cells with less clearance are never entered
+    double penaltyRadius = 0.0; // Moves into cells with less clearance pay extra:
+    double penaltyWeight = 0.0; // penaltyWeight * (penaltyRadius - clearance) per unit distance
+};
+
+// One non-dominated (distance, energy) pair of the label searches. Labels
+// live in a pool reused across searches; the constrained search also links
+// the open labels of each cell through it.
+struct EnergyLabel {
+    double distance;
+    double energy;
+    uint32_t parent; // Label this one extends, NO_PARENT at the start
+    uint32_t next;   // Next label of the same cell
+    int x, y;
+    bool active;     // Cleared once another label dominates it
+};
+
+// One route on the distance/energy trade-off curve
+struct ParetoPath {
+    std::vector<Point> path;
+    double distance; // Flight distance, in cells
+    double energy;   // As Optimizer::calculatePathEnergy
+};
+
 class Optimizer {
 private:
     const Terrain& terrain;
+    SearchWorkspace workspace;
+    std::vector<double> arrivalTime; // Per cell, for time-dependent searches
+    std::vector<EnergyLabel> labelPool;
+    std::vector<uint32_t> labelHead;   // Per cell, first open label of its Pareto list
+    std::vector<double> settledEnergy; // Per cell, energy of the last label settled there
+    std::vector<SearchWorkspace> spurWorkspaces; // One per thread of findKPaths
     
     // A* algorithm implementation
     std::vector<Point> reconstructPath(PathNode* goalNode);
+    std::vector<Point> reconstructPath(const SearchWorkspace& ws, uint32_t goalCell) const;
     double calculateDistance(const Point& a, const Point& b) const;
     
+    // Backward Dijkstra of the label searches: least energy from each cell
+    // to the goal into workspace.gScore, for the cells it settles before
+    // passing budget (the rest stay unseen or above budget), and resets the
+    // per-cell label state of every cell it reaches. Moves into penalised
+    // cells other than the goal cost penalty times more (infinite: never).
+    void backwardEnergySearch(const Point& start, const Point& goal, double budget,
+                              const std::vector<uint8_t>* penalised = nullptr, double penalty = 1.0);
+    
     // Hash function for Point in unordered_map
     struct PointHash {
         size_t operator()(const Point& p) const {
@@ -55,6 +155,9 @@ public:
     // Path optimization
     std::vector<Point> optimizePath(const std::vector<Point>& path);
     double calculatePathCost(const std::vector<Point>& path) const;
+    // Energy drawn flying the path: each step costs the entered cell's cost
+    // times the step length, the metric findPathAStar minimises
+    double calculatePathEnergy(const std::vector<Point>& path) const;
     
     // Utility methods
     bool isPathValid(const std::vector<Point>& path) const;
@@ -65,6 +168,82 @@ public:
     
     // Multi-objective optimization (energy + distance)
     std::vector<Point> findEnergyOptimalPath(const Point& start, const Point& goal, double energyWeight = 1.0);
+    
+    // Shortest route by flight distance whose energy (calculatePathEnergy)
+    // stays within the budget. Labels carry (distance, energy) and each
+    // cell keeps only its non-dominated ones. A bounded backward Dijkstra
+    // first computes the least energy from every cell to the goal: it
+    // prunes any label that could not finish within the budget, and when
+    // the start itself cannot, proves that no route exists (the result is
+    // then empty). The least-energy route bounds the distance from above.
+    // Energies within rounding of the budget count as within it, so a
+    // budget of exactly the least energy always finds a route.
+    std::vector<Point> findEnergyConstrainedPath(const Point& start, const Point& goal, double energyBudget);
+    // Same, within the drone's current energy less its reserve
+    std::vector<Point> findEnergyConstrainedPath(const Point& start, const Point& goal, const Drone& drone);
+    
+    // Every Pareto-optimal (distance, energy) route in one bi-objective
+    // label-setting search, from the shortest to the least-energy route;
+    // routes tied on both objectives are reported once. Labels are popped
+    // in lexicographic (distance, energy) order against exact energy lower
+    // bounds from one backward Dijkstra, so a label is dominated exactly
+    // when it does not beat the energy of the last label settled at its
+    // cell, or of the last route found: each check is O(1). maxFrontSize
+    // above 0 caps the front: after the shortest route, routes must save at
+    // least 1 / (maxFrontSize - 1) of the energy range over the previous
+    // one, which also prunes the search. The least-energy route is always
+    // the last one, except with maxFrontSize 1: the front is then only the
+    // shortest route. Empty when the goal is unreachable.
+    std::vector<ParetoPath> findParetoPaths(const Point& start, const Point& goal, size_t maxFrontSize = 0);
+    
+    // Up to k loopless alternative routes, cheapest first by the metric of
+    // findPathAStar (calculatePathEnergy); the first is findPathAStar's.
+    // Yen's algorithm: each accepted route is re-searched from every cell
+    // after the one where it left its parent route, with that root fixed
+    // and the next moves of routes sharing the root blocked. These spur
+    // searches are independent, so they run in parallel, one reused
+    // workspace per thread (threadCount = 0 picks a default), guided by
+    // exact energies from one backward Dijkstra.
+    // diversity in [0, 1] is the share of a route's length that must stay
+    // off every route accepted before it; cells of accepted routes also
+    // cost 1 / (1 - diversity) times more in the spur searches, steering
+    // them away (1 forbids them). With 0 the result is exactly the k
+    // cheapest loopless routes. Fewer come back when the map has no more
+    // routes that differ enough.
+    std::vector<std::vector<Point>> findKPaths(const Point& start, const Point& goal, size_t k,
+                                               double diversity = 0.0, unsigned threadCount = 0);
+    
+    // A* over the terrain's directional edge costs, so flying with the wind
+    // is cheaper than flying into it. Same as findPathAStar without a wind field.
+    std::vector<Point> findWindOptimalPath(const Point& start, const Point& goal);
+    
+    // A* that keeps away from obstacles: a hard minimum clearance, a soft
+    // penalty near obstacles, or both. Clearance is read from the
+    // precomputed field (refreshed here if the terrain changed), so a move
+    // costs one lookup. The start cell is exempt from minClearance so a
+    // drone can always leave a tight spot.
+    std::vector<Point> findClearancePath(const Point& start, const Point& goal,
+                                         ClearanceField& clearance, const ClearanceOptions& options);
+    
+    // A* over (x, y, flight level). Horizontal moves stay on a level and
+    // need a free column there; vertical moves pay the climb or descend cost
+    // per level. The route takes off from the start column's floor and lands
+    // on the goal column's floor; it is empty when either column is fully
+    // blocked or the goal is unreachable. Search state is allocated per
+    // visited column, one per level of its free run, so memory follows the
+    // explored airspace rather than width * height * levels. Time does
+    // not: the search still expands several levels per column, roughly
+    // ten times findPathAStar corner to corner on a 2048 x 2048 map.
+    std::vector<FlightPoint> findFlightPath(const Point& start, const Point& goal, const FlightLevels& levels);
+    
+    // Wind-aware A* against a forecast: each move is priced with the wind
+    // interpolated at the time the drone starts it. Flight time per move is
+    // distance over ground speed (airspeed minus headwind). The search uses
+    // one forecast snapshot throughout and keeps the cheapest arrival per
+    // cell, which is exact for a static forecast.
+    std::vector<Point> findTimeDependentPath(const Point& start, const Point& goal,
+                                             const WindForecast& forecast,
+                                             double departureTime, double airspeed);
 };
 
 #endif
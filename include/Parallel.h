@@ -0,0 +1,57 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <exception>
+
+// Number of worker threads to use when the caller passes 0
+inline unsigned defaultThreadCount() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : hw;
+}
+
+// Split [begin, end) into one contiguous chunk per thread and call
+// fn(chunkBegin, chunkEnd, chunkIndex) for each. The calling thread runs the
+// first chunk itself; the first exception thrown by any chunk is rethrown.
+template <typename Fn>
+void parallelFor(size_t begin, size_t end, unsigned threads, Fn fn) {
+    if (end <= begin) return;
+    if (threads == 0) threads = defaultThreadCount();
+    size_t total = end - begin;
+    threads = static_cast<unsigned>(std::min<size_t>(threads, total));
+
+    if (threads <= 1) {
+        fn(begin, end, 0u);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    auto runChunk = [&](unsigned chunk) {
+        size_t lo = begin + total * chunk / threads;
+        size_t hi = begin + total * (chunk + 1) / threads;
+        try {
+            fn(lo, hi, chunk);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+
+    for (unsigned chunk = 1; chunk < threads; chunk++) {
+        workers.emplace_back(runChunk, chunk);
+    }
+    runChunk(0);
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef PYRAMID_PLANNER_H
+#define PYRAMID_PLANNER_H
+
+#include <vector>
+#include <cstdint>
+#include "CostPyramid.h"
+#include "Optimizer.h"
+
+// Settings for PyramidPlanner
+struct PyramidOptions {
+    int corridorRadius = 2;      // Corridor half-width, in cells of the coarser level
+    int finestLevel = 0;         // Above 0, stop early and return block centres
+    double partialPenalty = 2.0; // Cost factor on blocks that contain obstacles
+};
+
+// Coarse-to-fine route search over a CostPyramid. The route is first
+// solved on the coarsest level; each finer level then only searches the
+// corridor of cells whose parent block lies within corridorRadius of the
+// coarser route, so the work per level is proportional to route length,
+// not map area.
+//
+// A coarse block is passable when any of its cells is, and a fine path
+// always maps onto a chain of adjacent passable blocks, so an unreachable
+// goal is detected on the coarsest level. When a corridor turns out to be
+// too narrow the radius doubles until it covers the level, which makes the
+// search complete. Routes are approximate: the corridor can exclude the
+// optimum, typically by a few percent of its cost.
+class PyramidPlanner {
+private:
+    CostPyramid& pyramid;
+    const Terrain& terrain;
+    PyramidOptions options;
+    SearchWorkspace workspace;       // Row-major per level
+    std::vector<uint32_t> corridor;  // Per cell: stamp of the last corridor containing it
+    uint32_t corridorStamp;
+    double lastPathCost;
+    size_t expandedNodes;
+
+    // Mark the level-k cells under the coarser route, widened by radius;
+    // false when the widened corridor already covers the whole level
+    bool markCorridor(int k, const std::vector<Point>& coarser, int radius);
+
+    // A* on level k, inside the current corridor when restricted; the route
+    // is written in level-k cells
+    bool searchLevel(int k, const Point& start, const Point& goal, bool restricted, std::vector<Point>& route);
+
+public:
+    explicit PyramidPlanner(CostPyramid& pyramidRef, const PyramidOptions& plannerOptions = PyramidOptions());
+
+    const PyramidOptions& getOptions() const { return options; }
+    void setOptions(const PyramidOptions& plannerOptions) { options = plannerOptions; }
+
+    // Brings the pyramid up to date, then returns a cell-by-cell path like
+    // Optimizer::findPathAStar (finestLevel 0) or the centre cells of the
+    // route's blocks (finestLevel above 0); empty when unreachable
+    std::vector<Point> findPath(const Point& start, const Point& goal);
+
+    // Route cost on the finest level searched: terrain costs on level 0,
+    // block rates (per block step) above it
+    double getLastPathCost() const { return lastPathCost; }
+    // Nodes popped over all levels of the last search
+    size_t getExpandedNodes() const { return expandedNodes; }
+};
+
+#endif
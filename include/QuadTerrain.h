@@ -0,0 +1,143 @@
+#ifndef QUAD_TERRAIN_H
+#define QUAD_TERRAIN_H
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include "Terrain.h"
+
+// Square, aligned region of identical cells (same type, elevation and wind)
+struct UniformBlock {
+    int x, y;   // Top-left corner, clipped to the map
+    int width, height;
+    TerrainType type;
+    double movementCost;
+
+    bool contains(const Point& p) const {
+        return p.x >= x && p.x < x + width && p.y >= y && p.y < y + height;
+    }
+};
+
+// Quadtree-backed, read-only terrain store. Square regions whose cells are
+// all identical collapse into a single leaf, so mostly-uniform maps take a
+// few bytes per region instead of per cell. Cells outside the map read as
+// OBSTACLE, matching Terrain::getTerrain.
+//
+// The tree is built from rows in bands of BAND_ROWS: each band's blocks
+// collapse as soon as the band is read, and the levels above join the
+// block roots. Built from a row source (e.g. MapParser::loadQuadTerrain),
+// the only flat storage is one band, so the full grid never exists. Built
+// from a Terrain, that Terrain is already in memory and the saving only
+// counts once it is freed.
+//
+// Distinct (type, elevation, wind) values share a palette. On noisy maps
+// nearly every cell is distinct, so the palette grows to a cell each and
+// nothing collapses; a quantum above zero rounds elevation and wind to its
+// multiples so such maps still merge, at that much loss of precision.
+class QuadTerrain {
+private:
+    // Distinct cell values; leaves refer to them by index
+    struct CellValue {
+        TerrainType type;
+        double elevation;
+        double windResistance;
+        double movementCost;
+    };
+
+    // child == LEAF: leaf holding palette[value]; otherwise child is the
+    // index of the first of four consecutive children (NW, NE, SW, SE)
+    struct QuadNode {
+        uint32_t child;
+        uint32_t value;
+    };
+
+    static constexpr uint32_t LEAF = UINT32_MAX;
+
+    // Palette lookup by the exact bits of a (rounded) cell value
+    struct CellKey {
+        uint64_t elevation;
+        uint64_t wind;
+        uint8_t type;
+
+        bool operator==(const CellKey& other) const {
+            return elevation == other.elevation && wind == other.wind && type == other.type;
+        }
+    };
+    struct CellKeyHash {
+        size_t operator()(const CellKey& key) const {
+            uint64_t h = key.elevation * 0x9E3779B97F4A7C15ULL ^ key.wind;
+            return static_cast<size_t>((h ^ (h >> 29)) * 0xBF58476D1CE4E5B9ULL ^ key.type);
+        }
+    };
+
+    // Rows [bandY, bandY + rows) of the map being built
+    struct Band {
+        int bandY = 0;
+        int rows = 0;
+        std::vector<TerrainType> types;
+        std::vector<double> elevation;
+        std::vector<double> wind;
+    };
+
+    std::vector<QuadNode> nodes;
+    std::vector<CellValue> palette;
+    std::unordered_map<CellKey, uint32_t, CellKeyHash> paletteIndex; // Only during a build
+    int width, height;
+    int rootSize; // Power of two covering the whole map
+    double quantum;
+    CostProfile costProfile;
+
+    uint32_t valueOf(TerrainType type, double elevation, double wind);
+    // Subtree of one square inside the current band
+    QuadNode buildBlock(const Band& band, int x, int y, int size);
+    // Levels above the blocks, joining the block roots
+    QuadNode buildUpper(const std::vector<QuadNode>& blockRoots, int blocksX, int blockSize,
+                        int x, int y, int size);
+    // The node of four children reserved at first, collapsed if all four
+    // are the same leaf
+    QuadNode join(uint32_t first, const QuadNode (&children)[4]);
+
+    // Leaf covering (x, y) plus its square's corner and size
+    const QuadNode& findLeaf(int x, int y, int& leafX, int& leafY, int& leafSize) const;
+
+public:
+    // Fills one row of the map: width types, elevations and winds. Called
+    // once per row, top to bottom.
+    using RowSource = std::function<void(int y, TerrainType* types, double* elevation, double* wind)>;
+
+    // Rows per band of the build; a power of two
+    static constexpr int BAND_ROWS = 64;
+
+    // quantum > 0 rounds elevation and wind to its multiples (see above)
+    explicit QuadTerrain(const Terrain& terrain, double quantum = 0.0);
+    QuadTerrain(int width, int height, const CostProfile& profile, const RowSource& rows, double quantum = 0.0);
+
+    // Re-read every cell
+    void rebuild(const Terrain& terrain);
+    void rebuild(int width, int height, const CostProfile& profile, const RowSource& rows);
+
+    // Point lookups
+    TerrainType getTerrain(int x, int y) const;
+    double getElevation(int x, int y) const;
+    double getWindResistance(int x, int y) const;
+    double getMovementCost(const Point& pos) const;
+    bool isPassable(const Point& pos) const;
+
+    // Largest aligned uniform square containing (x, y), clipped to the map.
+    // Any two cells inside it can be joined by a straight run of identical
+    // cost, so a search may cross it in a single edge.
+    UniformBlock largestUniformBlock(int x, int y) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    double getQuantum() const { return quantum; }
+    size_t paletteSize() const { return palette.size(); }
+
+    // Storage statistics
+    size_t nodeCount() const { return nodes.size(); }
+    size_t leafCount() const;
+    size_t memoryBytes() const;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef RECT_DECOMPOSITION_H
+#define RECT_DECOMPOSITION_H
+
+#include <vector>
+#include <cstdint>
+#include "Terrain.h"
+
+// Axis-aligned block of passable cells that all share one movement cost.
+// Bounds are inclusive.
+struct CostRect {
+    int x0, y0, x1, y1;
+    double cost;
+
+    bool contains(int x, int y) const { return x >= x0 && x <= x1 && y >= y0 && y <= y1; }
+    bool onPerimeter(int x, int y) const { return x == x0 || x == x1 || y == y0 || y == y1; }
+    int width() const { return x1 - x0 + 1; }
+    int height() const { return y1 - y0 + 1; }
+};
+
+// Partition of a terrain's passable cells into uniform-cost rectangles.
+// Rectangles are grown greedily (widest run first, then as many matching
+// rows as possible). The decomposition registers itself as a listener and
+// re-splits only the rectangles an edit touches, so it always matches the
+// terrain; rebuild() restores maximal rectangles after many edits.
+class RectDecomposition : public TerrainListener {
+public:
+    static constexpr uint32_t NO_RECT = UINT32_MAX;
+
+private:
+    const Terrain& terrain;
+    std::vector<CostRect> rects;
+    std::vector<uint32_t> freeIds;  // Slots in rects left by split rectangles
+    std::vector<uint32_t> rectOf;   // Row-major, NO_RECT for obstacles
+    size_t liveRects;
+    uint64_t version;               // Terrain version the rectangles match
+
+    size_t cell(int x, int y) const { return static_cast<size_t>(y) * terrain.getWidth() + x; }
+
+    uint32_t allocateRect(const CostRect& rect);
+    void label(const CostRect& rect, uint32_t id);
+
+    // Cover every unassigned passable cell inside the inclusive box
+    void decompose(int x0, int y0, int x1, int y1);
+
+public:
+    explicit RectDecomposition(const Terrain& terrainRef);
+    ~RectDecomposition();
+
+    RectDecomposition(const RectDecomposition&) = delete;
+    RectDecomposition& operator=(const RectDecomposition&) = delete;
+
+    // Decompose the whole map from scratch
+    void rebuild();
+
+    // TerrainListener: split the rectangles overlapping the edited box
+    // and re-cover the box
+    void onTerrainChanged(int x0, int y0, int x1, int y1) override;
+
+    const Terrain& getTerrain() const { return terrain; }
+    bool isCurrent() const { return version == terrain.getVersion(); }
+
+    // Rectangle containing a cell, or NO_RECT for obstacles / off-map cells
+    uint32_t rectAt(int x, int y) const {
+        if (x < 0 || y < 0 || x >= terrain.getWidth() || y >= terrain.getHeight()) return NO_RECT;
+        return rectOf[cell(x, y)];
+    }
+    const CostRect& getRect(uint32_t id) const { return rects[id]; }
+    size_t rectCount() const { return liveRects; }
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef RECT_PLANNER_H
+#define RECT_PLANNER_H
+
+#include <vector>
+#include "RectDecomposition.h"
+#include "Optimizer.h"
+
+// A* over the perimeters of a RectDecomposition (Rectangular Symmetry
+// Reduction). Interior cells of a rectangle are never expanded: a perimeter
+// cell reaches the far side of its rectangle through macro edges of cost
+// cost * octile distance, which is exactly what grid A* pays for the same
+// crossing, so the returned paths have the same cost as findPathAStar.
+// Macro edges are generated during the search, never stored.
+class RectPlanner {
+private:
+    const RectDecomposition& rects;
+    const Terrain& terrain;
+    SearchWorkspace workspace; // Indexed row-major, independent of the terrain layout
+    size_t expandedNodes;
+
+    // Append the grid cells of an in-rectangle move from a to b (exclusive
+    // of a): diagonal steps first, then straight ones
+    static void appendSegment(std::vector<Point>& path, const Point& a, const Point& b);
+
+public:
+    explicit RectPlanner(const RectDecomposition& decomposition);
+
+    // Cell-by-cell path in the same format as Optimizer::findPathAStar
+    std::vector<Point> findPath(const Point& start, const Point& goal);
+
+    // Nodes popped by the last search
+    size_t getExpandedNodes() const { return expandedNodes; }
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef STATION_PLANNER_H
+#define STATION_PLANNER_H
+
+#include <vector>
+#include <cstdint>
+#include "Terrain.h"
+#include "Optimizer.h"
+
+// Edge of the station graph: the least energy to fly to another station
+struct StationLink {
+    uint32_t to;   // Index into StationPlanner::getStations()
+    double energy;
+};
+
+// Route through energy stations, as returned by StationPlanner
+struct StationRoute {
+    std::vector<Point> path;  // Cell by cell, start to goal; empty when unreachable
+    std::vector<Point> stops; // Stations where the drone recharges, in flight order
+    double energy = 0.0;      // Total energy over all legs
+};
+
+// Long-range routing through ENERGY_STATION cells. A drone leaves the
+// start with some energy, recharges to legRange at every stop, and no leg
+// may draw more than the energy it set off with. Energy is the metric of
+// Optimizer::calculatePathEnergy, so each leg is a findPathAStar route.
+//
+// The station graph holds, for every pair of stations within legRange of
+// each other, the least energy between them. It is built with one bounded
+// Dijkstra per station, spread across threads, and rebuilt on the next
+// refresh() after any terrain edit. A query runs two more bounded searches
+// to join the start and goal to the graph, a Dijkstra over the stations,
+// and finally A* for the legs of the chosen route.
+class StationPlanner : public TerrainListener {
+private:
+    const Terrain& terrain;
+    double legRange;
+    unsigned threads;
+    std::vector<Point> stations;
+    std::vector<uint32_t> stationOf;             // Per cell (Terrain::cellIndex), station index or NO_STATION
+    std::vector<std::vector<StationLink>> links; // Per station, stations within legRange
+    uint64_t version;                            // Terrain version the graph matches
+    bool built;
+    Optimizer optimizer;
+
+    void build();
+
+    // Least energy from (forward) or to (!forward) the given cell to every
+    // station within budget; the origin's own station is skipped
+    void reachStations(const Point& origin, double budget, bool forward, SearchWorkspace& ws,
+                       std::vector<StationLink>& reached) const;
+
+public:
+    static constexpr uint32_t NO_STATION = UINT32_MAX;
+
+    // legRange: energy available after each recharge (e.g. a drone's
+    // capacity less its reserve); threads = 0 picks a default
+    StationPlanner(const Terrain& terrainRef, double legRange, unsigned threadCount = 0);
+    ~StationPlanner();
+
+    StationPlanner(const StationPlanner&) = delete;
+    StationPlanner& operator=(const StationPlanner&) = delete;
+
+    // Rebuild the station graph if the terrain changed since the last build
+    void refresh();
+    bool isCurrent() const { return built && version == terrain.getVersion(); }
+
+    // TerrainListener: edits only mark the graph stale
+    void onTerrainChanged(int x0, int y0, int x1, int y1) override;
+
+    const Terrain& getTerrain() const { return terrain; }
+    double getLegRange() const { return legRange; }
+
+    // Graph accessors need a current graph (see refresh())
+    const std::vector<Point>& getStations() const { return stations; }
+    const std::vector<StationLink>& getLinks(size_t station) const { return links[station]; }
+    size_t linkCount() const;
+
+    // Least-energy route from start to goal, leaving with startEnergy and
+    // recharging to legRange at each stop. Brings the graph up to date
+    // first. A goal within reach needs no stops.
+    StationRoute findRoute(const Point& start, const Point& goal, double startEnergy);
+};
+
+#endif
@@ -3,32 +3,260 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "Drone.h"
+#include "TerrainLayer.h"
 
-enum class TerrainType {
+enum class TerrainType : uint8_t {
     NORMAL = 0,
     HILL = 1,
     OBSTACLE = 2,
     WIND_ZONE = 3,
     START = 4,
-    END = 5
+    END = 5,
+    ENERGY_STATION = 6,
+    DANGER_ZONE = 7
+};
+
+// Whether a byte read from a map file names a TerrainType
+inline bool isTerrainTypeByte(uint8_t value) {
+    return value <= static_cast<uint8_t>(TerrainType::DANGER_ZONE);
+}
+
+// Cell ordering inside the terrain layers. MORTON stores the map as 8x8
+// tiles (tiles row-major, cells Z-ordered inside each tile), so the 8
+// neighbours of a cell are usually a few cache lines away, not a full row.
+enum class CellLayout : uint8_t {
+    ROW_MAJOR = 0,
+    MORTON = 1
+};
+
+// Per-cell storage encoding. PACKED keeps every cell in a single uint32_t
+// (4-bit type, 14-bit elevation, 14-bit wind resistance) instead of the
+// separate type/elevation/wind/cost layers, cutting 25 bytes per cell to 4.
+enum class CellEncoding : uint8_t {
+    FULL = 0,
+    PACKED = 1
+};
+
+// Wind at a cell: the direction the air moves, in the map's x/y axes
+struct WindVector {
+    float x, y;
+};
+
+// Cost of the 8 moves out of a cell, in Terrain::DIRECTION_DX/DY order;
+// +infinity where the move leaves the map or enters an obstacle. Aligned
+// to 32 bytes so a search pulls in all eight with a single vector load.
+struct alignas(32) DirectionalCosts {
+    float cost[8];
+};
+
+// Movement cost model: a per-terrain-type base cost plus elevation and wind
+// resistance terms. Terrain bakes it into a per-cell cost layer, so tuning
+// it (e.g. from config.json) costs nothing per lookup.
+struct CostProfile {
+    static constexpr int TYPE_SLOTS = 16; // Room for every 4-bit type value
+    
+    static constexpr double DEFAULT_NORMAL_COST = 1.0;
+    static constexpr double DEFAULT_HILL_COST = 3.0;
+    static constexpr double DEFAULT_WIND_COST = 2.0;
+    static constexpr double DEFAULT_OBSTACLE_COST = 1000.0; // Effectively impassable
+    static constexpr double DEFAULT_ENERGY_STATION_COST = 0.5;
+    static constexpr double DEFAULT_DANGER_ZONE_COST = 10.0;
+    static constexpr double DEFAULT_HEADWIND_FACTOR = 0.25;
+    static constexpr double DEFAULT_MIN_WIND_SCALE = 0.25;
+    
+    double typeCost[TYPE_SLOTS];
+    double obstacleCost;
+    double elevationFactor;
+    double windFactor;
+    
+    // Wind vector model for directional edge costs: a move's cost is scaled
+    // by 1 + headwindFactor * headwind (negative for tailwind), but never
+    // below minWindScale. Not part of fingerprint(): the baked per-cell
+    // cost layer does not depend on them.
+    double headwindFactor;
+    double minWindScale;
+    
+    CostProfile();
+    
+    void setTypeCost(TerrainType type, double cost) { typeCost[static_cast<uint8_t>(type) & (TYPE_SLOTS - 1)] = cost; }
+    double getTypeCost(TerrainType type) const { return typeCost[static_cast<uint8_t>(type) & (TYPE_SLOTS - 1)]; }
+    
+    double cellCost(TerrainType type, double elevation, double wind) const {
+        if (type == TerrainType::OBSTACLE) return obstacleCost;
+        return getTypeCost(type) + elevation * elevationFactor + wind * windFactor;
+    }
+    
+    double windScale(double headwind) const {
+        double scale = 1.0 + headwindFactor * headwind;
+        return scale > minWindScale ? scale : minWindScale;
+    }
+    
+    // Stable hash of all parameters, used to validate baked cost layers
+    uint64_t fingerprint() const;
+};
+
+// Values written by the bulk edit operations (fillRect, fillCircle,
+// fillPolygon). Only the fields selected with the with* calls are written;
+// the others keep each cell's current value.
+struct TerrainBrush {
+    static constexpr uint8_t TYPE = 1;
+    static constexpr uint8_t ELEVATION = 2;
+    static constexpr uint8_t WIND = 4;
+    
+    uint8_t fields = 0;
+    TerrainType type = TerrainType::NORMAL;
+    double elevation = 0.0;
+    double wind = 0.0;
+    
+    TerrainBrush& withType(TerrainType value) { type = value; fields |= TYPE; return *this; }
+    TerrainBrush& withElevation(double value) { elevation = value; fields |= ELEVATION; return *this; }
+    TerrainBrush& withWind(double value) { wind = value; fields |= WIND; return *this; }
+};
+
+// Observer for terrain edits. Terrain calls onTerrainChanged with the
+// inclusive bounding box of the cells whose type, elevation, wind or cost
+// may have changed, after the new values are in place.
+class TerrainListener {
+public:
+    virtual ~TerrainListener() {}
+    virtual void onTerrainChanged(int x0, int y0, int x1, int y1) = 0;
 };
 
 class Terrain {
 private:
-    std::vector<std::vector<TerrainType>> grid;
-    std::vector<std::vector<double>> elevationMap;
-    std::vector<std::vector<double>> windResistance;
+    // Row-major cell layers, owned or mapped from a .uavmap file
+    TerrainLayer<TerrainType> grid;
+    TerrainLayer<double> elevationMap;
+    TerrainLayer<double> windResistance;
     int width, height;
+    CellEncoding encoding;
+    TerrainLayer<uint32_t> packedCells; // Only populated in PACKED encoding
+    CellLayout layout;
+    int tilesX; // Tiles per tile row in the MORTON layout
+    
+    static constexpr int TILE_BITS = 3;
+    static constexpr int TILE_SIZE = 1 << TILE_BITS;
+    static constexpr int TILE_MASK = TILE_SIZE - 1;
+    
+    // Spread the low 3 bits of v to even bit positions (0, 2, 4)
+    static size_t spreadTileBits(int v) {
+        static constexpr uint8_t spread[TILE_SIZE] = {0, 1, 4, 5, 16, 17, 20, 21};
+        return spread[v & TILE_MASK];
+    }
+    
+    static size_t layoutIndex(CellLayout layout, int width, int tilesX, int x, int y) {
+        if (layout == CellLayout::ROW_MAJOR) {
+            return static_cast<size_t>(y) * width + x;
+        }
+        size_t tile = static_cast<size_t>(y >> TILE_BITS) * tilesX + (x >> TILE_BITS);
+        return (tile << (2 * TILE_BITS)) | spreadTileBits(x) | (spreadTileBits(y) << 1);
+    }
+    
+    // Cached movement cost per cell, derived from costProfile
+    CostProfile costProfile;
+    TerrainLayer<double> costLayer;
+    double minCellCost; // Lower bound on any passable cell's cost
     
-    // Cost calculation constants
-    static constexpr double NORMAL_COST = 1.0;
-    static constexpr double HILL_COST = 3.0;
-    static constexpr double WIND_COST = 2.0;
-    static constexpr double OBSTACLE_COST = 1000.0; // Effectively impassable
+    // Optional wind vector field and the directional edge costs derived from
+    // it; both stay empty until a wind vector is set
+    TerrainLayer<WindVector> windField;
+    TerrainLayer<DirectionalCosts> edgeCosts;
+    double minEdgeRate; // Lower bound on edge cost per unit of distance
+    
+    float computeEdgeCost(int x, int y, int direction) const;
+    void updateEdgeCosts(int x, int y) { updateEdgeCosts(x, y, x, y); }
+    
+    void updateCellCost(size_t i) {
+        if (encoding == CellEncoding::FULL) {
+            costLayer[i] = costProfile.cellCost(grid[i], elevationMap[i], windResistance[i]);
+        }
+        if (cellType(i) != TerrainType::OBSTACLE && cellCost(i) < minCellCost) {
+            minCellCost = cellCost(i);
+        }
+    }
+    
+    size_t index(int x, int y) const { return layoutIndex(layout, width, tilesX, x, y); }
+    
+    // Registered observers belong to this object only: copies and moves of
+    // a Terrain start without listeners, and assignment keeps the target's
+    struct ListenerList {
+        std::vector<TerrainListener*> items;
+        
+        ListenerList() {}
+        ListenerList(const ListenerList&) {}
+        ListenerList& operator=(const ListenerList&) { return *this; }
+    };
+    
+    mutable ListenerList listeners;
+    uint64_t version; // Bumped on every edit
+    
+    void notifyChanged(int x0, int y0, int x1, int y1);
+    
+    // Edit batching: inside beginBatch/endBatch, edits grow a dirty box
+    // instead of notifying, and endBatch reports it once
+    int batchDepth;
+    int dirtyX0, dirtyY0, dirtyX1, dirtyY1; // Empty when dirtyX0 > dirtyX1
+    void markChanged(int x0, int y0, int x1, int y1);
+    
+    // Summed-area tables, (width + 1) * (height + 1) entries each: entry
+    // (X, Y) sums the cells with x < X and y < Y. Built on the first region
+    // query; an edit only marks the entries right of and below its corner
+    // stale, and the next query recomputes just those.
+    mutable std::vector<double> costSums;
+    mutable std::vector<uint32_t> obstacleSums;
+    mutable int sumsStaleX, sumsStaleY; // Cells from here on changed since the last update
+    void updateRegionSums() const;
+    
+    // Brush a span of one row (x0 <= x1, both inside the map) without
+    // notifying; edge costs are left to the caller
+    void paintSpan(int y, int x0, int x1, const TerrainBrush& brush);
+    void updateEdgeCosts(int x0, int y0, int x1, int y1); // Box plus a 1-cell margin
+    
+    // Grow (with NORMAL rows) or truncate to newHeight rows; reserveRows
+    // preallocates for streaming loaders that know the height up front,
+    // and trimRows releases capacity beyond the current rows. All only
+    // apply to ROW_MAJOR terrains.
+    void resizeRows(int newHeight);
+    void reserveRows(int rows);
+    void trimRows();
+    
+    // Parsers and generators write rows straight into the layers
+    friend class MapParser;
+    friend class TerrainSynthesizer;
     
 public:
-    Terrain(int w, int h);
+    // A PACKED terrain never allocates the full-precision layers, so very
+    // large maps can be created directly in the compact encoding
+    Terrain(int w, int h, const CostProfile& profile = CostProfile(),
+            CellEncoding cellEncoding = CellEncoding::FULL);
+    
+    // Assigning replaces the whole map under the target's listeners: they
+    // are told of a whole-map change, and the version moves past both
+    // operands' versions so nothing built from either looks current
+    Terrain(const Terrain&) = default;
+    Terrain(Terrain&&) = default;
+    Terrain& operator=(const Terrain& other);
+    Terrain& operator=(Terrain&& other);
+    
+    // Binary map support: layers are used in place from the mapped file.
+    // A baked cost layer is reused when it was built with the same profile.
+    static Terrain fromBinaryFile(const std::string& filename,
+                                  const CostProfile& profile = CostProfile());
+    bool isMapped() const { return grid.isMapped(); }
+    
+    // Change tracking: derived structures register here to stay in sync.
+    // Listeners are not owned and must unregister before they are destroyed.
+    void addListener(TerrainListener* listener) const;
+    void removeListener(TerrainListener* listener) const;
+    uint64_t getVersion() const { return version; }
+    
+    // Group edits into one change: listeners get a single notification with
+    // the bounding box of everything edited, and the version moves once.
+    // Batches nest; only the outermost endBatch notifies.
+    void beginBatch();
+    void endBatch();
     
     // Grid management
     void setTerrain(int x, int y, TerrainType type);
@@ -47,6 +275,30 @@ public:
     double getMovementCost(const Point& pos) const;
     double getHeuristicCost(const Point& from, const Point& to) const;
     
+    // Cost model: changing the profile rebakes the whole cost layer
+    void setCostProfile(const CostProfile& profile);
+    const CostProfile& getCostProfile() const { return costProfile; }
+    void rebuildCostLayer();
+    double getMinCellCost() const { return minCellCost; }
+    
+    // Wind vector field. The first setWindVector/setWindField call creates
+    // a calm field plus the per-direction edge cost layer (32 bytes per
+    // cell); edits keep the edge costs in sync.
+    static constexpr int DIRECTION_COUNT = 8;
+    static constexpr int DIRECTION_DX[DIRECTION_COUNT] = {-1, -1, -1, 0, 0, 1, 1, 1};
+    static constexpr int DIRECTION_DY[DIRECTION_COUNT] = {-1, 0, 1, -1, 1, -1, 0, 1};
+    
+    bool hasWindField() const { return windField.size() != 0; }
+    void setWindVector(int x, int y, float wx, float wy);
+    WindVector getWindVector(int x, int y) const;
+    void setWindField(const WindVector* rowMajor); // width*height vectors
+    void clearWindField();
+    void rebuildEdgeCosts();
+    
+    // Edge costs of the moves out of a layer index (requires a wind field)
+    const DirectionalCosts& edgeCostsAt(size_t cell) const { return edgeCosts[cell]; }
+    double getMinEdgeRate() const { return minEdgeRate; }
+    
     // Visualization
     void visualizeTerrain() const;
     void visualizePath(const std::vector<Point>& path) const;
@@ -56,14 +308,103 @@ public:
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     
+    // Cell layout: setLayout reorders every layer in place and notifies
+    // listeners of the whole map, since cell indices move; cellIndex and
+    // cellPoint convert between grid coordinates and layer indices
+    CellLayout getLayout() const { return layout; }
+    void setLayout(CellLayout newLayout);
+    size_t cellIndex(int x, int y) const { return index(x, y); }
+    Point cellPoint(size_t cell) const;
+    size_t cellCount() const { return encoding == CellEncoding::FULL ? grid.size() : packedCells.size(); }
+    
+    // Cell encoding: setEncoding converts every cell in place
+    CellEncoding getEncoding() const { return encoding; }
+    void setEncoding(CellEncoding newEncoding);
+    
+    // Packed cell format: bits 0-3 type, 4-17 elevation, 18-31 wind
+    // resistance. Values are quantized in steps of PACKED_VALUE_STEP over
+    // [0, PACKED_VALUE_MAX]; any value in that range round-trips to within
+    // PACKED_VALUE_STEP / 2, values outside it are clamped to the range.
+    static constexpr int PACKED_VALUE_BITS = 14;
+    static constexpr uint32_t PACKED_VALUE_MASK = (1u << PACKED_VALUE_BITS) - 1;
+    static constexpr double PACKED_VALUE_STEP = 1.0 / 1024.0;
+    static constexpr double PACKED_VALUE_MAX = PACKED_VALUE_MASK * PACKED_VALUE_STEP;
+    
+    static uint32_t packCell(TerrainType type, double elevation, double wind);
+    static TerrainType packedType(uint32_t cell) { return static_cast<TerrainType>(cell & 0xF); }
+    static double packedElevation(uint32_t cell) { return ((cell >> 4) & PACKED_VALUE_MASK) * PACKED_VALUE_STEP; }
+    static double packedWind(uint32_t cell) { return (cell >> 18) * PACKED_VALUE_STEP; }
+    
+    // Fast per-index access for search kernels, valid in either encoding
+    TerrainType cellType(size_t cell) const {
+        return encoding == CellEncoding::FULL ? grid[cell] : packedType(packedCells[cell]);
+    }
+    double cellCost(size_t cell) const {
+        if (encoding == CellEncoding::FULL) return costLayer[cell];
+        uint32_t packed = packedCells[cell];
+        return costProfile.cellCost(packedType(packed), packedElevation(packed), packedWind(packed));
+    }
+    
+    // Decode count cells starting at layer index first into the given
+    // arrays (any may be null); works in either encoding
+    void unpackCells(size_t first, size_t count, TerrainType* types, double* elevation, double* wind) const;
+    
+    // Raw layer access (cellCount() cells each, ordered by getLayout()).
+    // The type/elevation/wind/cost layers are empty in PACKED encoding.
+    const TerrainType* terrainData() const { return grid.data(); }
+    const double* elevationData() const { return elevationMap.data(); }
+    const double* windData() const { return windResistance.data(); }
+    const double* costData() const { return costLayer.data(); }
+    const uint32_t* packedData() const { return packedCells.data(); }
+    
+    // Region queries over the inclusive box (x0, y0)-(x1, y1), clipped to
+    // the map, in O(1) from summed-area tables. regionCost adds
+    // getMovementCost over the box (obstacles at the profile's obstacle
+    // cost), exact up to floating-point rounding. The tables take 12 bytes
+    // per cell and are brought up to date by the first query after an
+    // edit, so call refreshRegionSums() before querying from several
+    // threads at once.
+    double regionCost(int x0, int y0, int x1, int y1) const;
+    size_t regionObstacleCount(int x0, int y0, int x1, int y1) const;
+    void refreshRegionSums() const { updateRegionSums(); }
+    
     // Neighbors for pathfinding
     std::vector<Point> getNeighbors(const Point& pos) const;
     
-    // Terrain generation
+    // Terrain generation. The seeded form is reproducible: cell (x, y) only
+    // depends on the seed, so rows are generated in parallel (threads = 0
+    // picks a default) with bit-identical output for any thread count. The
+    // unseeded form draws a seed from std::random_device.
     void generateRandomTerrain(double obstacleProb = 0.2, double hillProb = 0.1, double windProb = 0.1);
+    void generateRandomTerrain(double obstacleProb, double hillProb, double windProb,
+                               uint64_t seed, unsigned threads = 0);
     void addObstacle(const Point& pos);
     void addHill(const Point& pos);
     void addWindZone(const Point& pos);
+    void addEnergyStation(const Point& pos);
+    
+    // Every ENERGY_STATION cell, in row-major order
+    std::vector<Point> getEnergyStations() const;
+    
+    // Polygon vertex in continuous map coordinates
+    struct Vertex {
+        double x, y;
+    };
+    
+    // Bulk edits for zones and geofences. Shapes are clipped to the map and
+    // written a row span at a time; each call is one batch (one version
+    // bump, one notification with the dirty box) unless it runs inside an
+    // enclosing beginBatch/endBatch.
+    // fillRect: the inclusive cell box (x0, y0)-(x1, y1), in either order
+    void fillRect(int x0, int y0, int x1, int y1, const TerrainBrush& brush);
+    // fillCircle: cells whose centre is within radius of centre's centre
+    void fillCircle(const Point& centre, double radius, const TerrainBrush& brush);
+    // fillPolygon: vertices are cell-corner coordinates (cell (x, y) spans
+    // [x, x + 1) x [y, y + 1)) and may be fractional, as geofence
+    // projections are; a cell is filled when its centre is inside the
+    // polygon by the even-odd rule, so polygons sharing an edge never both
+    // claim a cell.
+    void fillPolygon(const std::vector<Vertex>& vertices, const TerrainBrush& brush);
 };
 
 #endif
@@ -0,0 +1,110 @@
+#ifndef TERRAIN_LAYER_H
+#define TERRAIN_LAYER_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "MappedFile.h"
+
+// Flat per-cell storage for one terrain attribute. The cells either live in
+// an owned vector or point straight into a memory-mapped map file, so a
+// binary map can be used in place without copying.
+template <typename T>
+class TerrainLayer {
+private:
+    std::vector<T> storage;
+    std::shared_ptr<MappedFile> mapping;
+    T* cells;
+    size_t count;
+
+public:
+    TerrainLayer() : cells(nullptr), count(0) {}
+
+    // Copies always own their cells; edits must never leak between copies
+    TerrainLayer(const TerrainLayer& other)
+        : storage(other.cells, other.cells + other.count), cells(storage.data()), count(other.count) {}
+
+    TerrainLayer(TerrainLayer&& other) noexcept
+        : storage(std::move(other.storage)), mapping(std::move(other.mapping)),
+          cells(other.cells), count(other.count) {
+        other.cells = nullptr;
+        other.count = 0;
+    }
+
+    TerrainLayer& operator=(const TerrainLayer& other) {
+        if (this != &other) {
+            storage.assign(other.cells, other.cells + other.count);
+            mapping.reset();
+            cells = storage.data();
+            count = other.count;
+        }
+        return *this;
+    }
+
+    TerrainLayer& operator=(TerrainLayer&& other) noexcept {
+        if (this != &other) {
+            storage = std::move(other.storage);
+            mapping = std::move(other.mapping);
+            cells = other.cells;
+            count = other.count;
+            other.cells = nullptr;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    // Owned storage filled with a single value
+    void allocate(size_t cellCount, T value) {
+        mapping.reset();
+        storage.assign(cellCount, value);
+        cells = storage.data();
+        count = cellCount;
+    }
+
+    // Grow or shrink to cellCount cells; mapped layers become owned
+    void resize(size_t cellCount, T value) {
+        if (mapping) {
+            storage.assign(cells, cells + std::min(count, cellCount));
+            mapping.reset();
+        }
+        storage.resize(cellCount, value);
+        cells = storage.data();
+        count = cellCount;
+    }
+
+    // Preallocate owned storage for cellCount cells
+    void reserve(size_t cellCount) {
+        if (!mapping) {
+            storage.reserve(cellCount);
+            cells = storage.data();
+        }
+    }
+
+    // Release owned capacity beyond the current cells
+    void shrinkToFit() {
+        if (!mapping) {
+            storage.shrink_to_fit();
+            cells = storage.data();
+        }
+    }
+
+    // Use cellCount values starting at byteOffset of the mapping in place
+    void attach(const std::shared_ptr<MappedFile>& file, size_t byteOffset, size_t cellCount) {
+        storage.clear();
+        storage.shrink_to_fit();
+        mapping = file;
+        cells = reinterpret_cast<T*>(file->data() + byteOffset);
+        count = cellCount;
+    }
+
+    bool isMapped() const { return mapping != nullptr; }
+    size_t size() const { return count; }
+
+    T* data() { return cells; }
+    const T* data() const { return cells; }
+
+    T& operator[](size_t i) { return cells[i]; }
+    const T& operator[](size_t i) const { return cells[i]; }
+};
+
+#endif
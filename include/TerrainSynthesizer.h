@@ -0,0 +1,50 @@
+#ifndef TERRAIN_SYNTHESIZER_H
+#define TERRAIN_SYNTHESIZER_H
+
+#include <cstdint>
+#include "Terrain.h"
+
+// Parameters for fractal value-noise terrain. Noise values are in [0, 1);
+// the levels below are thresholds on that scale.
+struct NoiseSettings {
+    double featureSize = 96.0;   // Cells per lattice step of the first octave
+    int octaves = 5;
+    double persistence = 0.5;    // Amplitude factor per octave
+    double lacunarity = 2.0;     // Frequency factor per octave
+    bool ridged = false;         // Fold elevation into sharp ridge lines
+
+    double baseLevel = 0.45;     // Elevation noise where the ground starts rising
+    double hillLevel = 0.60;     // ... and turns into HILL
+    double obstacleLevel = 0.69; // ... and into impassable OBSTACLE peaks
+    double windLevel = 0.64;     // Wind noise above this forms WIND_ZONE corridors
+
+    double maxElevation = 15.0;  // Stays inside the PACKED value range
+    double maxWind = 3.0;
+};
+
+// Procedural terrain from two independent fractal value-noise fields, one
+// for elevation and one for wind. Rows are synthesized independently (the
+// lattice values come from CounterRng), so work splits across threads and
+// the output only depends on the seed. Each octave adds straight spans of
+// linear interpolation into a row buffer with an SSE2 kernel where
+// available.
+class TerrainSynthesizer {
+private:
+    NoiseSettings settings;
+
+public:
+    explicit TerrainSynthesizer(const NoiseSettings& noiseSettings = NoiseSettings());
+
+    const NoiseSettings& getSettings() const { return settings; }
+
+    // Overwrite every cell of terrain (any layout or encoding);
+    // threads = 0 picks a default
+    void fill(Terrain& terrain, uint64_t seed, unsigned threads = 0) const;
+
+    // New terrain filled from the seed
+    Terrain generate(int width, int height, uint64_t seed,
+                     CellEncoding encoding = CellEncoding::FULL,
+                     const CostProfile& profile = CostProfile(), unsigned threads = 0) const;
+};
+
+#endif
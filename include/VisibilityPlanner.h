@@ -0,0 +1,75 @@
+#ifndef VISIBILITY_PLANNER_H
+#define VISIBILITY_PLANNER_H
+
+#include <vector>
+#include <cstdint>
+#include "Terrain.h"
+
+// Any-angle planner for maps with few, blocky obstacles. The free cells
+// diagonal to a convex obstacle corner are the only places a shortest
+// route needs to bend, so the planner links those cells by line of sight
+// and runs Dijkstra on that small graph, connecting start and goal per
+// query. Straight segments are only exact when every passable cell costs
+// the same, so maps with HILL/WIND (or any other) cost variation are
+// reported as not applicable. Path cost is Euclidean length times that
+// cost, so it is usually below findPathAStar's 8-connected cost; it can be
+// slightly above it where grid moves cut past a lone obstacle corner.
+class VisibilityPlanner {
+private:
+    const Terrain& terrain;
+    std::vector<Point> corners;
+
+    // Per corner, bit d marks a convex obstacle corner in diagonal d
+    // (bit 0 = (-1,-1), 1 = (+1,-1), 2 = (-1,+1), 3 = (+1,+1));
+    // ANY_DIRECTION marks squeeze gaps, which bend in any direction
+    static constexpr uint8_t ANY_DIRECTION = 0xFF;
+    std::vector<uint8_t> cornerMask;
+
+    // Visibility graph in compressed rows: edges of corner i are
+    // [edgeStart[i], edgeStart[i + 1])
+    std::vector<uint32_t> edgeStart;
+    std::vector<uint32_t> edgeTarget;
+    std::vector<double> edgeLength;
+
+    std::vector<uint8_t> blockedCells; // Row-major obstacle mask for line-of-sight walks
+    bool applicable;
+    double uniformCost;
+    uint64_t builtVersion;
+    bool built;
+    double lastPathCost;
+
+    // A shortest route only bends at a corner along lines that graze the
+    // obstacle there; others are skipped before any line-of-sight walk
+    bool isTangent(size_t corner, const Point& other) const;
+
+    // lineOfSight over blockedCells; both ends must be passable
+    bool clearSegment(const Point& a, const Point& b) const;
+
+    // Rebuild corners and edges when the terrain changed since the last build
+    void ensureBuilt();
+    void build();
+
+public:
+    explicit VisibilityPlanner(const Terrain& terrainRef);
+
+    // False when passable cells differ in cost
+    bool isApplicable();
+
+    // Waypoints from start to goal (start, bend cells..., goal), empty when
+    // unreachable. Throws std::runtime_error if the planner does not apply.
+    std::vector<Point> findPath(const Point& start, const Point& goal);
+    double getLastPathCost() const { return lastPathCost; }
+
+    // Cell centres joined by a straight segment that only crosses passable
+    // cells. Like grid moves, the segment may slip between two obstacles
+    // that touch only at a corner.
+    bool lineOfSight(const Point& a, const Point& b) const;
+
+    // Every cell the waypoint segments pass through, as 8-connected steps
+    static std::vector<Point> expandPath(const std::vector<Point>& waypoints);
+
+    size_t cornerCount() { ensureBuilt(); return corners.size(); }
+    size_t edgeCount() { ensureBuilt(); return edgeTarget.size() / 2; }
+};
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef WIND_FORECAST_H
+#define WIND_FORECAST_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <istream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include "Terrain.h"
+
+// One forecast frame: the wind over the whole map at a point in time
+struct WindFrame {
+    double time;
+    std::vector<WindVector> field; // width*height, row-major
+};
+
+// Time-indexed stack of wind frames for one map size. The published frame
+// set is immutable and shared: readers grab it with snapshot() and keep
+// using it for a whole query, while appends build the next set aside and
+// swap it in atomically, so ingesting a forecast never blocks a search.
+// Writers (appendFrame, loadFrames, a streamFile thread) may run
+// concurrently; they take turns on a lock that readers never touch.
+//
+// Text forecast format (whitespace separated):
+//   frame <time>
+//   <wx> <wy> repeated width*height times, row-major
+//   frame <time>
+//   ...
+class WindForecast {
+public:
+    struct FrameSet {
+        std::vector<std::shared_ptr<const WindFrame>> frames; // Sorted by time
+    };
+    typedef std::shared_ptr<const FrameSet> Snapshot;
+
+    // The two frames around a time and the weight of the later one
+    struct Blend {
+        const WindFrame* before;
+        const WindFrame* after;
+        float weight;
+    };
+
+private:
+    int width, height;
+    Snapshot published;
+    std::mutex writeMutex; // Serializes appends; snapshot() never takes it
+
+    std::thread streamThread;
+    std::atomic<bool> streaming;
+    std::exception_ptr streamError;
+
+    // Parse one frame body after its "frame <time>" header
+    std::vector<WindVector> readField(std::istream& in, double time) const;
+
+public:
+    WindForecast(int w, int h);
+    ~WindForecast();
+
+    WindForecast(const WindForecast&) = delete;
+    WindForecast& operator=(const WindForecast&) = delete;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Insert a frame (replacing one at the same time) and publish the new
+    // set; safe to call from several threads at once
+    void appendFrame(double time, std::vector<WindVector> field);
+
+    // Read frames from a stream, publishing each as soon as it is parsed;
+    // returns the number of frames read. Throws std::runtime_error on
+    // malformed input.
+    size_t loadFrames(std::istream& in);
+
+    // Ingest a forecast file on a background thread while searches go on
+    void streamFile(const std::string& filename);
+    bool isStreaming() const { return streaming.load(); }
+    // Wait for the background reader; rethrows its error, if any
+    void waitForStream();
+
+    // Current frame set; stays valid while held, whatever gets appended
+    Snapshot snapshot() const;
+    size_t frameCount() const { return snapshot()->frames.size(); }
+
+    // Wind at a time is linear between the bracketing frames and held
+    // constant outside them; calm when there are no frames. Searches look
+    // up the blend once per time and then sample many cells with it.
+    static Blend blendAt(const FrameSet& set, double time);
+    static WindVector sample(const Blend& blend, size_t rowMajorCell) {
+        if (!blend.before) return WindVector{0.0f, 0.0f};
+        const WindVector& a = blend.before->field[rowMajorCell];
+        const WindVector& b = blend.after->field[rowMajorCell];
+        return WindVector{a.x + (b.x - a.x) * blend.weight, a.y + (b.y - a.y) * blend.weight};
+    }
+    WindVector sample(int x, int y, double time) const;
+
+    // Whole-map wind at a time, e.g. for Terrain::setWindField
+    void sampleField(double time, std::vector<WindVector>& field) const;
+};
+
+#endif
@@ -8,6 +8,7 @@
 #include "include/Terrain.h"
 #include "include/Drone.h"
 #include "include/Optimizer.h"
+#include "include/StationPlanner.h"
 
 // ANSI color codes for green terminal output
 #define RESET   "\033[0m"
@@ -19,6 +20,8 @@ void printUsage() {
     std::cout << "Usage: ./uav_optimizer [map_file] [start_x] [start_y] [end_x] [end_y]\n";
     std::cout << "Example: ./uav_optimizer maps/sample_map.txt 0 0 9 9\n";
     std::cout << "If no arguments provided, default sample will be used.\n";
+    std::cout << "Use '-' as map_file to stream the map from stdin.\n";
+    std::cout << "Convert a text map to binary: ./uav_optimizer --convert <map.txt> <map.uavmap|map.uavrle>\n";
 }
 
 void displayResults(const std::vector<Point>& path, const Terrain& terrain, 
@@ -40,6 +43,8 @@ void displayResults(const std::vector<Point>& path, const Terrain& terrain,
         std::cout << GREEN << "^ = Hill (High Cost)" << RESET << "\n";
         std::cout << GREEN << "W = Wind Zone" << RESET << "\n";
         std::cout << GREEN << "* = Flight Path" << RESET << "\n";
+        std::cout << GREEN << "E = Energy Station" << RESET << "\n";
+        std::cout << GREEN << "X = Danger Zone" << RESET << "\n";
         std::cout << GREEN << ". = Normal Terrain" << RESET << "\n";
     } else {
         std::cout << GREEN << "No path found! Target may be unreachable." << RESET << "\n";
@@ -76,7 +81,24 @@ int main(int argc, char* argv[]) {
     Point end(9, 9);
     
     // Parse command line arguments
-    if (argc == 6) {
+    if (argc == 4 && std::string(argv[1]) == "--convert") {
+        try {
+            MapParser parser;
+            std::string output = argv[3];
+            bool compressed = output.size() >= 7 && output.compare(output.size() - 7, 7, ".uavrle") == 0;
+            bool saved = compressed ? parser.saveCompressed(parser.loadMap(argv[2]), output)
+                                    : parser.convertToBinary(argv[2], output);
+            if (!saved) {
+                std::cerr << "Error: Could not write binary map: " << argv[3] << "\n";
+                return 1;
+            }
+            std::cout << GREEN << "Converted map saved to: " << argv[3] << RESET << "\n";
+            return 0;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    } else if (argc == 6) {
         mapFile = argv[1];
         start.x = std::stoi(argv[2]);
         start.y = std::stoi(argv[3]);
@@ -89,7 +111,9 @@ int main(int argc, char* argv[]) {
     
     try {
         // Initialize components
+        // Cost tuning comes from config.json when present
         MapParser parser;
+        parser.loadConfiguration("config.json", false);
         Terrain terrain = parser.loadMap(mapFile);
         
         // Validate start and end points
@@ -105,6 +129,7 @@ int main(int argc, char* argv[]) {
         
         // Initialize drone and optimizer
         Drone drone(start, 1000.0); // 1000 energy units
+        drone.setReserveFraction(0.15); // Land with at least 15% left
         Optimizer optimizer(terrain);
         
         std::cout << GREEN << "Map loaded: " << mapFile << RESET << "\n";
@@ -142,8 +167,21 @@ int main(int argc, char* argv[]) {
             std::cout << GREEN << "\nWarning: Computation time exceeded 2 seconds threshold!" << RESET << "\n";
         }
         
-        if (totalEnergy > drone.getMaxEnergy() * 0.85) {
-            std::cout << GREEN << "\nWarning: Energy consumption exceeded 85% threshold!" << RESET << "\n";
+        // The A* route draws the least energy, so if it eats into the
+        // reserve no direct route can avoid it: look for recharge stops
+        if (!path.empty() && optimizer.calculatePathEnergy(path) > drone.getUsableEnergy()) {
+            std::cout << GREEN << "\nWarning: No direct route reaches the destination without using the "
+                      << drone.getReserveFraction() * 100.0 << "% energy reserve!" << RESET << "\n";
+            
+            StationPlanner stations(terrain, drone.getMaxEnergy() * (1.0 - drone.getReserveFraction()));
+            StationRoute route = stations.findRoute(start, end, drone.getUsableEnergy());
+            if (!route.path.empty()) {
+                std::cout << GREEN << "Route with " << route.stops.size() << " recharge stop(s):";
+                for (const Point& stop : route.stops) {
+                    std::cout << " (" << stop.x << ", " << stop.y << ")";
+                }
+                std::cout << ", " << route.energy << " energy units" << RESET << "\n";
+            }
         }
         
         std::cout << BRIGHT_GREEN << "\nSimulation completed successfully!" << RESET << "\n";
@@ -0,0 +1,152 @@
+#include "../include/ClearanceField.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+ClearanceField::ClearanceField(const Terrain& terrainRef, unsigned threadCount)
+    : terrain(terrainRef), version(0), built(false), threads(threadCount) {
+    terrain.addListener(this);
+    build();
+}
+
+ClearanceField::~ClearanceField() {
+    terrain.removeListener(this);
+}
+
+void ClearanceField::onTerrainChanged(int, int, int, int) {
+    // Any obstacle can move every distance, so the whole field is rebuilt
+    // lazily; a burst of single-cell edits costs one transform
+    built = false;
+}
+
+void ClearanceField::refresh() {
+    if (!isCurrent()) build();
+}
+
+void ClearanceField::build() {
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const size_t cells = static_cast<size_t>(width) * height;
+    distance.assign(terrain.cellCount(), std::numeric_limits<float>::infinity());
+    blocked.resize(cells);
+    column.resize(cells);
+    version = terrain.getVersion();
+    built = true;
+    if (cells == 0) return;
+
+    unsigned workers = threads != 0 ? threads : (cells >= (1u << 20) ? defaultThreadCount() : 1);
+
+    // Row-major layers are read and written a row at a time
+    const bool rowMajor = terrain.getLayout() == CellLayout::ROW_MAJOR;
+    const TerrainType* rowMajorTypes =
+        rowMajor && terrain.getEncoding() == CellEncoding::FULL ? terrain.terrainData() : nullptr;
+
+    // Farther than any real distance; squares stay well inside int64
+    const int32_t far = width + height;
+
+    parallelFor(0, height, workers, [&](size_t begin, size_t end, unsigned) {
+        for (int y = static_cast<int>(begin); y < static_cast<int>(end); y++) {
+            uint8_t* row = blocked.data() + static_cast<size_t>(y) * width;
+            if (rowMajorTypes) {
+                const TerrainType* types = rowMajorTypes + static_cast<size_t>(y) * width;
+                for (int x = 0; x < width; x++) {
+                    row[x] = types[x] == TerrainType::OBSTACLE;
+                }
+                continue;
+            }
+            for (int x = 0; x < width; x++) {
+                row[x] = terrain.cellType(terrain.cellIndex(x, y)) == TerrainType::OBSTACLE;
+            }
+        }
+    });
+
+    // Pass 1: vertical distance to the nearest obstacle, down then up. Each
+    // worker owns a band of columns and sweeps it a row at a time, so the
+    // inner loops run over contiguous memory with no dependency between x.
+    const size_t band = 256;
+    size_t bands = (static_cast<size_t>(width) + band - 1) / band;
+    parallelFor(0, bands, workers, [&](size_t first, size_t last, unsigned) {
+        int x0 = static_cast<int>(first * band);
+        int x1 = static_cast<int>(std::min(last * band, static_cast<size_t>(width)));
+        int span = x1 - x0;
+
+        const uint8_t* mask = blocked.data() + x0;
+        int32_t* g = column.data() + x0;
+        for (int x = 0; x < span; x++) {
+            g[x] = mask[x] ? 0 : far;
+        }
+        for (int y = 1; y < height; y++) {
+            const uint8_t* m = mask + static_cast<size_t>(y) * width;
+            const int32_t* above = g + static_cast<size_t>(y - 1) * width;
+            int32_t* here = g + static_cast<size_t>(y) * width;
+            for (int x = 0; x < span; x++) {
+                here[x] = m[x] ? 0 : std::min(above[x] + 1, far);
+            }
+        }
+        for (int y = height - 2; y >= 0; y--) {
+            const int32_t* below = g + static_cast<size_t>(y + 1) * width;
+            int32_t* here = g + static_cast<size_t>(y) * width;
+            for (int x = 0; x < span; x++) {
+                here[x] = std::min(here[x], below[x] + 1);
+            }
+        }
+    });
+
+    // Pass 2: per row, the lower envelope of the parabolas
+    // (x - i)^2 + g(i)^2 gives the squared distance at every x
+    const double unreachable = static_cast<double>(far) * far;
+    parallelFor(0, height, workers, [&](size_t begin, size_t end, unsigned) {
+        // Felzenszwalb-Huttenlocher form: site[k] is the column of the k-th
+        // envelope parabola, which is lowest on [bound[k], bound[k + 1])
+        std::vector<int> site(width);
+        std::vector<double> bound(width + 1);
+        std::vector<double> g2(width);
+
+        for (int y = static_cast<int>(begin); y < static_cast<int>(end); y++) {
+            const int32_t* g = column.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; x++) {
+                g2[x] = static_cast<double>(g[x]) * g[x];
+            }
+
+            int k = 0;
+            site[0] = 0;
+            bound[0] = -std::numeric_limits<double>::infinity();
+            bound[1] = std::numeric_limits<double>::infinity();
+            for (int u = 1; u < width; u++) {
+                // Intersection with the top parabola; pop it while u hides it
+                double s;
+                while (true) {
+                    int i = site[k];
+                    s = ((g2[u] + static_cast<double>(u) * u) - (g2[i] + static_cast<double>(i) * i)) / (2.0 * (u - i));
+                    if (s > bound[k] || k == 0) break;
+                    k--;
+                }
+                if (k == 0 && s <= bound[0]) {
+                    site[0] = u;
+                } else {
+                    k++;
+                    site[k] = u;
+                    bound[k] = s;
+                }
+                bound[k + 1] = std::numeric_limits<double>::infinity();
+            }
+
+            float* out = rowMajor ? distance.data() + static_cast<size_t>(y) * width : nullptr;
+            k = 0;
+            for (int x = 0; x < width; x++) {
+                while (bound[k + 1] < x) k++;
+                double dx = x - site[k];
+                double squared = dx * dx + g2[site[k]];
+                if (squared < unreachable) {
+                    float d = static_cast<float>(std::sqrt(squared));
+                    if (out) {
+                        out[x] = d;
+                    } else {
+                        distance[terrain.cellIndex(x, y)] = d;
+                    }
+                }
+            }
+        }
+    });
+}
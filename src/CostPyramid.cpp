@@ -0,0 +1,174 @@
+#include "../include/CostPyramid.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const float BLOCKED = std::numeric_limits<float>::infinity();
+
+// out[i] = op over the 2x2 block a[2i], a[2i + 1], b[2i], b[2i + 1]; an odd
+// last column reduces a single pair
+template <bool MAX>
+void reducePairs(const float* a, const float* b, int count, float* out) {
+    int pairs = count / 2;
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= pairs; i += 4) {
+        __m128 a0 = _mm_loadu_ps(a + 2 * i);
+        __m128 a1 = _mm_loadu_ps(a + 2 * i + 4);
+        __m128 b0 = _mm_loadu_ps(b + 2 * i);
+        __m128 b1 = _mm_loadu_ps(b + 2 * i + 4);
+        __m128 v0 = MAX ? _mm_max_ps(a0, b0) : _mm_min_ps(a0, b0);
+        __m128 v1 = MAX ? _mm_max_ps(a1, b1) : _mm_min_ps(a1, b1);
+        __m128 even = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 odd = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(out + i, MAX ? _mm_max_ps(even, odd) : _mm_min_ps(even, odd));
+    }
+#endif
+    for (; i < pairs; i++) {
+        float left = MAX ? std::max(a[2 * i], b[2 * i]) : std::min(a[2 * i], b[2 * i]);
+        float right = MAX ? std::max(a[2 * i + 1], b[2 * i + 1]) : std::min(a[2 * i + 1], b[2 * i + 1]);
+        out[i] = MAX ? std::max(left, right) : std::min(left, right);
+    }
+    if (count % 2 != 0) {
+        out[pairs] = MAX ? std::max(a[count - 1], b[count - 1]) : std::min(a[count - 1], b[count - 1]);
+    }
+}
+
+}
+
+CostPyramid::CostPyramid(const Terrain& terrainRef, int topLevelSize)
+    : terrain(terrainRef), topSize(topLevelSize), stale(true), dirtyX0(0), dirtyY0(0), dirtyX1(-1), dirtyY1(-1) {
+    if (topLevelSize < 1) {
+        throw std::runtime_error("Pyramid top size must be positive");
+    }
+    terrain.addListener(this);
+    rebuild();
+}
+
+CostPyramid::~CostPyramid() {
+    terrain.removeListener(this);
+}
+
+void CostPyramid::onTerrainChanged(int x0, int y0, int x1, int y1) {
+    if (!stale) {
+        dirtyX0 = x0; dirtyY0 = y0; dirtyX1 = x1; dirtyY1 = y1;
+        stale = true;
+        return;
+    }
+    dirtyX0 = std::min(dirtyX0, x0);
+    dirtyY0 = std::min(dirtyY0, y0);
+    dirtyX1 = std::max(dirtyX1, x1);
+    dirtyY1 = std::max(dirtyY1, y1);
+}
+
+void CostPyramid::rebuild() {
+    levels.clear();
+    int width = terrain.getWidth();
+    int height = terrain.getHeight();
+    while (std::max(width, height) > topSize) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        PyramidLevel level;
+        level.width = width;
+        level.height = height;
+        level.minCost.assign(static_cast<size_t>(width) * height, BLOCKED);
+        level.maxCost.assign(static_cast<size_t>(width) * height, BLOCKED);
+        levels.push_back(std::move(level));
+    }
+    dirtyX0 = 0;
+    dirtyY0 = 0;
+    dirtyX1 = terrain.getWidth() - 1;
+    dirtyY1 = terrain.getHeight() - 1;
+    stale = true;
+    refresh();
+}
+
+void CostPyramid::refresh() {
+    if (!stale) return;
+    stale = false;
+
+    // Terrain resized since the last build
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    bool wantLevels = std::max(width, height) > topSize;
+    if (wantLevels != !levels.empty() ||
+        (wantLevels && (levels[0].width != (width + 1) / 2 || levels[0].height != (height + 1) / 2))) {
+        rebuild();
+        return;
+    }
+
+    int x0 = std::max(dirtyX0, 0), y0 = std::max(dirtyY0, 0);
+    int x1 = std::min(dirtyX1, width - 1), y1 = std::min(dirtyY1, height - 1);
+    if (x0 > x1 || y0 > y1) return;
+
+    for (int k = 1; k < levelCount(); k++) {
+        reduceLevel(k, x0 >> k, y0 >> k, x1 >> k, y1 >> k);
+    }
+}
+
+void CostPyramid::readCosts(int y, int x0, int x1, float* out) const {
+    if (terrain.getEncoding() == CellEncoding::FULL && terrain.getLayout() == CellLayout::ROW_MAJOR) {
+        size_t first = terrain.cellIndex(x0, y);
+        const TerrainType* types = terrain.terrainData() + first;
+        const double* costs = terrain.costData() + first;
+        for (int i = 0; i <= x1 - x0; i++) {
+            out[i] = types[i] == TerrainType::OBSTACLE ? BLOCKED : static_cast<float>(costs[i]);
+        }
+        return;
+    }
+    for (int x = x0; x <= x1; x++) {
+        size_t cell = terrain.cellIndex(x, y);
+        out[x - x0] = terrain.cellType(cell) == TerrainType::OBSTACLE ? BLOCKED : static_cast<float>(terrain.cellCost(cell));
+    }
+}
+
+void CostPyramid::reduceLevel(int k, int x0, int y0, int x1, int y1) {
+    PyramidLevel& target = levels[k - 1];
+    x1 = std::min(x1, target.width - 1);
+    y1 = std::min(y1, target.height - 1);
+    if (x0 > x1 || y0 > y1) return;
+
+    // Source rows/columns of the blocks, clipped to the level below
+    const int sourceWidth = k == 1 ? terrain.getWidth() : levels[k - 2].width;
+    const int sourceHeight = k == 1 ? terrain.getHeight() : levels[k - 2].height;
+    const int sx0 = 2 * x0;
+    const int sx1 = std::min(2 * x1 + 1, sourceWidth - 1);
+    const int count = sx1 - sx0 + 1;
+
+    size_t rows = static_cast<size_t>(y1 - y0 + 1);
+    unsigned threads = rows * count >= (1u << 20) ? defaultThreadCount() : 1;
+
+    parallelFor(y0, y1 + 1, threads, [&](size_t begin, size_t end, unsigned) {
+        std::vector<float> top, bottom;
+        if (k == 1) {
+            top.resize(count);
+            bottom.resize(count);
+        }
+        for (int y = static_cast<int>(begin); y < static_cast<int>(end); y++) {
+            int sy0 = 2 * y;
+            int sy1 = std::min(sy0 + 1, sourceHeight - 1); // An odd last row pairs with itself
+            float* minOut = target.minCost.data() + target.cell(x0, y);
+            float* maxOut = target.maxCost.data() + target.cell(x0, y);
+
+            if (k == 1) {
+                readCosts(sy0, sx0, sx1, top.data());
+                readCosts(sy1, sx0, sx1, bottom.data());
+                reducePairs<false>(top.data(), bottom.data(), count, minOut);
+                reducePairs<true>(top.data(), bottom.data(), count, maxOut);
+            } else {
+                const PyramidLevel& source = levels[k - 2];
+                reducePairs<false>(source.minCost.data() + source.cell(sx0, sy0),
+                                   source.minCost.data() + source.cell(sx0, sy1), count, minOut);
+                reducePairs<true>(source.maxCost.data() + source.cell(sx0, sy0),
+                                  source.maxCost.data() + source.cell(sx0, sy1), count, maxOut);
+            }
+        }
+    });
+}
@@ -1,9 +1,11 @@
 #include "../include/Drone.h"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <stdexcept>
 
 Drone::Drone(const Point& startPos, double maxEnergyCapacity) 
-    : position(startPos), maxEnergy(maxEnergyCapacity), currentEnergy(maxEnergyCapacity) {
+    : position(startPos), maxEnergy(maxEnergyCapacity), currentEnergy(maxEnergyCapacity), reserveFraction(0.0) {
     flightPath.clear();
     addToPath(startPos);
 }
@@ -36,6 +38,21 @@ bool Drone::hasEnergy(double required) const {
     return currentEnergy >= required;
 }
 
+void Drone::setReserveFraction(double fraction) {
+    if (!(fraction >= 0.0 && fraction <= 1.0)) {
+        throw std::runtime_error("Energy reserve must be between 0 and 1");
+    }
+    reserveFraction = fraction;
+}
+
+double Drone::getReserveFraction() const {
+    return reserveFraction;
+}
+
+double Drone::getUsableEnergy() const {
+    return std::max(0.0, currentEnergy - reserveFraction * maxEnergy);
+}
+
 void Drone::addToPath(const Point& point) {
     flightPath.push_back(point);
 }
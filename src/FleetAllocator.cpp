@@ -0,0 +1,256 @@
+#include "../include/FleetAllocator.h"
+#include "../include/MissionPlanner.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const size_t UNASSIGNED = FleetAllocator::NO_ASSIGNMENT;
+
+// Costs laid out for the solvers: row-major, never more rows than
+// columns (the caller's matrix is transposed when it is taller than wide),
+// and finite, with forbidden pairs priced so high that no optimum uses one
+// it can avoid
+struct CostTable {
+    size_t rows = 0;
+    size_t cols = 0;
+    bool transposed = false;
+    std::vector<double> cost;
+    double maxFinite = 0.0; // Largest finite |cost| of the caller's matrix
+    double spread = 0.0;    // Largest minus smallest entry of cost
+};
+
+CostTable makeTable(const std::vector<std::vector<double>>& costs) {
+    CostTable table;
+    size_t drones = costs.size();
+    size_t targets = drones == 0 ? 0 : costs[0].size();
+    for (const std::vector<double>& row : costs) {
+        if (row.size() != targets) {
+            throw std::runtime_error("Assignment costs must have the same number of targets per drone");
+        }
+        for (double c : row) {
+            if (std::isnan(c)) throw std::runtime_error("Assignment costs must not be NaN");
+            if (std::isfinite(c)) table.maxFinite = std::max(table.maxFinite, std::fabs(c));
+        }
+    }
+
+    table.transposed = drones > targets;
+    table.rows = std::min(drones, targets);
+    table.cols = std::max(drones, targets);
+    // More than any two matchings of finite pairs can differ by
+    double forbidden = 2.0 * (table.maxFinite + 1.0) * (table.rows + 1.0);
+
+    table.cost.resize(table.rows * table.cols);
+    double low = std::numeric_limits<double>::infinity();
+    double high = -low;
+    for (size_t drone = 0; drone < drones; drone++) {
+        for (size_t target = 0; target < targets; target++) {
+            double c = costs[drone][target];
+            if (!std::isfinite(c)) c = forbidden;
+            size_t index = table.transposed ? target * table.cols + drone : drone * table.cols + target;
+            table.cost[index] = c;
+            low = std::min(low, c);
+            high = std::max(high, c);
+        }
+    }
+    table.spread = table.cost.empty() ? 0.0 : high - low;
+    return table;
+}
+
+// Maps a column per table row back to drones and targets, leaving out the
+// forbidden pairs
+FleetAssignment makeAssignment(const std::vector<std::vector<double>>& costs, const CostTable& table,
+                               const std::vector<size_t>& colOf) {
+    FleetAssignment result;
+    size_t drones = costs.size();
+    size_t targets = drones == 0 ? 0 : costs[0].size();
+    result.targetOf.assign(drones, UNASSIGNED);
+    result.droneOf.assign(targets, UNASSIGNED);
+    for (size_t row = 0; row < table.rows; row++) {
+        size_t drone = table.transposed ? colOf[row] : row;
+        size_t target = table.transposed ? row : colOf[row];
+        double c = costs[drone][target];
+        if (!std::isfinite(c)) continue;
+        result.targetOf[drone] = target;
+        result.droneOf[target] = drone;
+        result.cost += c;
+    }
+    return result;
+}
+
+// Shortest augmenting paths with row and column potentials: each row
+// joins the matching along the cheapest path in reduced costs, O(n^2 m)
+// overall. Index 0 is a virtual column holding the row being added.
+std::vector<size_t> hungarian(const CostTable& table) {
+    const size_t n = table.rows;
+    const size_t m = table.cols;
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> rowPotential(n + 1, 0.0), colPotential(m + 1, 0.0), minSlack(m + 1);
+    std::vector<size_t> rowOf(m + 1, 0), previous(m + 1, 0); // Rows are 1-based here, 0 = none
+    std::vector<char> used(m + 1);
+
+    for (size_t row = 1; row <= n; row++) {
+        rowOf[0] = row;
+        size_t col = 0;
+        std::fill(minSlack.begin(), minSlack.end(), inf);
+        std::fill(used.begin(), used.end(), 0);
+        do {
+            used[col] = 1;
+            size_t current = rowOf[col];
+            const double* costs = &table.cost[(current - 1) * m];
+            double delta = inf;
+            size_t nextCol = 0;
+            for (size_t j = 1; j <= m; j++) {
+                if (used[j]) continue;
+                double slack = costs[j - 1] - rowPotential[current] - colPotential[j];
+                if (slack < minSlack[j]) {
+                    minSlack[j] = slack;
+                    previous[j] = col;
+                }
+                if (minSlack[j] < delta) {
+                    delta = minSlack[j];
+                    nextCol = j;
+                }
+            }
+            for (size_t j = 0; j <= m; j++) {
+                if (used[j]) {
+                    rowPotential[rowOf[j]] += delta;
+                    colPotential[j] -= delta;
+                } else {
+                    minSlack[j] -= delta;
+                }
+            }
+            col = nextCol;
+        } while (rowOf[col] != 0);
+
+        // Flip the matching along the path back to the virtual column
+        while (col != 0) {
+            size_t before = previous[col];
+            rowOf[col] = rowOf[before];
+            col = before;
+        }
+    }
+
+    std::vector<size_t> colOf(n, UNASSIGNED);
+    for (size_t j = 1; j <= m; j++) {
+        if (rowOf[j] != 0) colOf[rowOf[j] - 1] = j - 1;
+    }
+    return colOf;
+}
+
+// Every bidder ends within epsilon of its best column at the final prices,
+// so the last round is within cols * epsilon of the optimum
+const double AUCTION_TOLERANCE = 1e-6;
+// Epsilon shrinks by this much between rounds
+const double AUCTION_SCALING = 8.0;
+
+// Gauss-Seidel auction with epsilon scaling. The table is squared up with
+// cols - rows virtual rows that cost nothing anywhere. One row at a time
+// bids for its cheapest column at cost plus price, raising that price by
+// its margin over the second cheapest plus epsilon and evicting the
+// owner. Prices carry over between rounds while epsilon shrinks, so later
+// rounds start from nearly settled prices.
+std::vector<size_t> auction(const CostTable& table) {
+    const size_t n = table.rows;
+    const size_t m = table.cols;
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> price(m, 0.0);
+    std::vector<size_t> owner(m), colOf(m), unassigned;
+    unassigned.reserve(m);
+
+    double unit = table.maxFinite > 0.0 ? table.maxFinite : 1.0;
+    double finalEpsilon = unit * AUCTION_TOLERANCE / std::max<size_t>(m, 1);
+    double epsilon = std::max(finalEpsilon, table.spread / AUCTION_SCALING);
+
+    while (true) {
+        std::fill(owner.begin(), owner.end(), UNASSIGNED);
+        std::fill(colOf.begin(), colOf.end(), UNASSIGNED);
+        unassigned.clear();
+        for (size_t row = m; row-- > 0;) unassigned.push_back(row);
+
+        while (!unassigned.empty()) {
+            size_t row = unassigned.back();
+            unassigned.pop_back();
+
+            double best = inf, second = inf;
+            size_t bestCol = 0;
+            const double* costs = row < n ? &table.cost[row * m] : nullptr;
+            for (size_t j = 0; j < m; j++) {
+                double value = (costs ? costs[j] : 0.0) + price[j];
+                if (value < best) {
+                    second = best;
+                    best = value;
+                    bestCol = j;
+                } else if (value < second) {
+                    second = value;
+                }
+            }
+            if (second < inf) price[bestCol] += second - best + epsilon;
+
+            size_t evicted = owner[bestCol];
+            if (evicted != UNASSIGNED) {
+                colOf[evicted] = UNASSIGNED;
+                unassigned.push_back(evicted);
+            }
+            owner[bestCol] = row;
+            colOf[row] = bestCol;
+        }
+
+        if (epsilon <= finalEpsilon) break;
+        epsilon = std::max(finalEpsilon, epsilon / AUCTION_SCALING);
+    }
+
+    colOf.resize(n);
+    return colOf;
+}
+
+} // namespace
+
+FleetAllocator::FleetAllocator(const Terrain& terrainRef, unsigned threadCount)
+    : terrain(terrainRef), threads(threadCount) {}
+
+FleetAssignment FleetAllocator::allocate(const std::vector<Point>& drones, const std::vector<Point>& targets) const {
+    FleetAssignment result = solve(MissionPlanner(terrain, threads).costMatrix(drones, targets));
+    // Without drones the matrix has no rows to tell how many targets there are
+    result.droneOf.resize(targets.size(), NO_ASSIGNMENT);
+    return result;
+}
+
+FleetAssignment FleetAllocator::allocate(const std::vector<Drone>& drones, const std::vector<Point>& targets) const {
+    std::vector<Point> positions;
+    positions.reserve(drones.size());
+    for (const Drone& drone : drones) positions.push_back(drone.getPosition());
+
+    std::vector<std::vector<double>> costs = MissionPlanner(terrain, threads).costMatrix(positions, targets);
+    for (size_t i = 0; i < drones.size(); i++) {
+        double usable = drones[i].getUsableEnergy();
+        for (double& c : costs[i]) {
+            if (c > usable) c = std::numeric_limits<double>::infinity();
+        }
+    }
+    FleetAssignment result = solve(costs);
+    result.droneOf.resize(targets.size(), NO_ASSIGNMENT);
+    return result;
+}
+
+FleetAssignment FleetAllocator::solve(const std::vector<std::vector<double>>& costs) {
+    size_t drones = costs.size();
+    size_t targets = drones == 0 ? 0 : costs[0].size();
+    // Spare columns give the augmenting paths slack, so the Hungarian
+    // algorithm stays quick there, while the auction's virtual rows fight
+    // over them
+    if (drones != targets || drones <= HUNGARIAN_LIMIT) return solveHungarian(costs);
+    return solveAuction(costs);
+}
+
+FleetAssignment FleetAllocator::solveHungarian(const std::vector<std::vector<double>>& costs) {
+    CostTable table = makeTable(costs);
+    return makeAssignment(costs, table, hungarian(table));
+}
+
+FleetAssignment FleetAllocator::solveAuction(const std::vector<std::vector<double>>& costs) {
+    CostTable table = makeTable(costs);
+    return makeAssignment(costs, table, auction(table));
+}
@@ -0,0 +1,72 @@
+#include "../include/FlightLevels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+FlightLevels::FlightLevels(const Terrain& terrainRef, const FlightLevelSettings& levelSettings)
+    : terrain(terrainRef), settings(levelSettings), minAirRate(std::numeric_limits<double>::infinity()) {
+    if (settings.levelCount < 1 || settings.levelCount > 255 || !(settings.levelHeight > 0.0) ||
+        settings.climbCost < 0.0 || settings.descendCost < 0.0) {
+        throw std::runtime_error("Invalid flight level settings");
+    }
+    terrain.addListener(this);
+    updateColumns(0, 0, terrain.getWidth() - 1, terrain.getHeight() - 1);
+}
+
+FlightLevels::~FlightLevels() {
+    terrain.removeListener(this);
+}
+
+void FlightLevels::onTerrainChanged(int x0, int y0, int x1, int y1) {
+    if (floors.size() != terrain.cellCount()) {
+        // Resized or re-laid out: start over
+        minAirRate = std::numeric_limits<double>::infinity();
+        updateColumns(0, 0, terrain.getWidth() - 1, terrain.getHeight() - 1);
+        return;
+    }
+    updateColumns(x0, y0, x1, y1);
+}
+
+void FlightLevels::updateColumns(int x0, int y0, int x1, int y1) {
+    if (floors.size() != terrain.cellCount()) {
+        floors.assign(terrain.cellCount(), static_cast<uint8_t>(settings.levelCount));
+    }
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, terrain.getWidth() - 1);
+    y1 = std::min(y1, terrain.getHeight() - 1);
+
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            size_t cell = terrain.cellIndex(x, y);
+            int floor = settings.levelCount;
+            if (terrain.cellType(cell) != TerrainType::OBSTACLE) {
+                double level = std::ceil((terrain.getElevation(x, y) + settings.clearance) / settings.levelHeight);
+                floor = static_cast<int>(std::min<double>(std::max(level, 0.0), settings.levelCount));
+            }
+            floors[cell] = static_cast<uint8_t>(floor);
+            if (floor < settings.levelCount) {
+                minAirRate = std::min(minAirRate, airRate(x, y));
+            }
+        }
+    }
+    if (std::isinf(minAirRate)) {
+        minAirRate = 0.0;
+    }
+}
+
+int FlightLevels::getFloor(int x, int y) const {
+    if (x < 0 || y < 0 || x >= terrain.getWidth() || y >= terrain.getHeight()) {
+        return settings.levelCount;
+    }
+    return floors[terrain.cellIndex(x, y)];
+}
+
+double FlightLevels::airRate(int x, int y) const {
+    TerrainType type = terrain.getTerrain(x, y);
+    if (type == TerrainType::HILL) {
+        type = TerrainType::NORMAL;
+    }
+    return terrain.getCostProfile().cellCost(type, 0.0, terrain.getWindResistance(x, y));
+}
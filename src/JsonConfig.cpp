@@ -0,0 +1,172 @@
+#include "../include/JsonConfig.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cctype>
+#include <cstdlib>
+
+JsonConfig::JsonConfig() {}
+
+void JsonConfig::skipWhitespace(const std::string& text, size_t& pos) const {
+    while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+        pos++;
+    }
+}
+
+std::string JsonConfig::parseString(const std::string& text, size_t& pos) const {
+    // pos is on the opening quote
+    std::string result;
+    pos++;
+    while (pos < text.size() && text[pos] != '"') {
+        if (text[pos] == '\\' && pos + 1 < text.size()) {
+            pos++;
+            switch (text[pos]) {
+                case 'n': result.push_back('\n'); break;
+                case 't': result.push_back('\t'); break;
+                case 'r': result.push_back('\r'); break;
+                default: result.push_back(text[pos]); break; // \" \\ \/
+            }
+        } else {
+            result.push_back(text[pos]);
+        }
+        pos++;
+    }
+    if (pos >= text.size()) {
+        throw std::runtime_error("Unterminated string in JSON");
+    }
+    pos++;
+    return result;
+}
+
+void JsonConfig::parseValue(const std::string& text, size_t& pos, const std::string& key) {
+    skipWhitespace(text, pos);
+    if (pos >= text.size()) {
+        throw std::runtime_error("Unexpected end of JSON");
+    }
+
+    char c = text[pos];
+    if (c == '{') {
+        pos++;
+        skipWhitespace(text, pos);
+        if (pos < text.size() && text[pos] == '}') {
+            pos++;
+            return;
+        }
+        while (true) {
+            skipWhitespace(text, pos);
+            if (pos >= text.size() || text[pos] != '"') {
+                throw std::runtime_error("Expected key in JSON object");
+            }
+            std::string name = parseString(text, pos);
+            skipWhitespace(text, pos);
+            if (pos >= text.size() || text[pos] != ':') {
+                throw std::runtime_error("Expected ':' after key \"" + name + "\"");
+            }
+            pos++;
+            parseValue(text, pos, key.empty() ? name : key + "." + name);
+            skipWhitespace(text, pos);
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+            } else if (pos < text.size() && text[pos] == '}') {
+                pos++;
+                return;
+            } else {
+                throw std::runtime_error("Expected ',' or '}' in JSON object");
+            }
+        }
+    } else if (c == '[') {
+        pos++;
+        skipWhitespace(text, pos);
+        if (pos < text.size() && text[pos] == ']') {
+            pos++;
+            return;
+        }
+        for (int index = 0;; index++) {
+            parseValue(text, pos, key + "[" + std::to_string(index) + "]");
+            skipWhitespace(text, pos);
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+            } else if (pos < text.size() && text[pos] == ']') {
+                pos++;
+                return;
+            } else {
+                throw std::runtime_error("Expected ',' or ']' in JSON array");
+            }
+        }
+    } else if (c == '"') {
+        values[key] = parseString(text, pos);
+    } else {
+        // Number, true, false or null: keep the literal text
+        size_t start = pos;
+        while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' &&
+               !std::isspace(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+        if (pos == start) {
+            throw std::runtime_error("Expected value in JSON");
+        }
+        values[key] = text.substr(start, pos - start);
+    }
+}
+
+void JsonConfig::parse(const std::string& text) {
+    values.clear();
+    size_t pos = 0;
+    parseValue(text, pos, "");
+    skipWhitespace(text, pos);
+    if (pos != text.size()) {
+        throw std::runtime_error("Trailing characters after JSON document");
+    }
+}
+
+bool JsonConfig::loadFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    parse(buffer.str());
+    return true;
+}
+
+bool JsonConfig::has(const std::string& key) const {
+    return values.find(key) != values.end();
+}
+
+double JsonConfig::getNumber(const std::string& key, double defaultValue) const {
+    auto it = values.find(key);
+    if (it == values.end()) return defaultValue;
+
+    char* end = nullptr;
+    double value = std::strtod(it->second.c_str(), &end);
+    if (end == it->second.c_str() || *end != '\0') {
+        throw std::runtime_error("Config value for " + key + " is not a number: " + it->second);
+    }
+    return value;
+}
+
+uint64_t JsonConfig::getUnsigned(const std::string& key, uint64_t defaultValue) const {
+    auto it = values.find(key);
+    if (it == values.end()) return defaultValue;
+    
+    char* end = nullptr;
+    const char* text = it->second.c_str();
+    unsigned long long value = std::strtoull(text, &end, 10);
+    if (end == text || *end != '\0' || *text == '-') {
+        throw std::runtime_error("Config value for " + key + " is not an unsigned integer: " + it->second);
+    }
+    return static_cast<uint64_t>(value);
+}
+
+std::string JsonConfig::getString(const std::string& key, const std::string& defaultValue) const {
+    auto it = values.find(key);
+    return it == values.end() ? defaultValue : it->second;
+}
+
+bool JsonConfig::getBool(const std::string& key, bool defaultValue) const {
+    auto it = values.find(key);
+    if (it == values.end()) return defaultValue;
+    return it->second == "true";
+}
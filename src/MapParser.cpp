@@ -1,12 +1,146 @@
 #include "../include/MapParser.h"
+#include "../include/BinaryMapFormat.h"
+#include "../include/MappedFile.h"
+#include "../include/Parallel.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <random>
+#include <cstring>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Buffers smaller than this are always parsed on the calling thread
+static constexpr size_t PARALLEL_PARSE_THRESHOLD = 8 * 1024 * 1024;
+
+// Read size used by the streaming loaders
+static constexpr size_t STREAM_CHUNK_SIZE = 64 * 1024;
+
+namespace {
+
+// One non-empty text row: [begin, begin + length) without the line ending
+struct RowSpan {
+    const char* begin;
+    size_t length;
+};
+
+// Return the next non-empty row at or after pos, advancing pos past it.
+// Returns false when the buffer is exhausted.
+inline bool nextRow(const char*& pos, const char* end, RowSpan& row) {
+    while (pos < end) {
+        const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        const char* lineEnd = newline ? newline : end;
+        size_t length = lineEnd - pos;
+        
+        if (length > 0 && pos[length - 1] == '\r') {
+            length--;
+        }
+        
+        row.begin = pos;
+        row.length = length;
+        pos = newline ? newline + 1 : end;
+        
+        if (length > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void writeVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Bounds-checked cursor over a compressed map buffer
+struct ByteReader {
+    const unsigned char* pos;
+    const unsigned char* end;
+    
+    void require(size_t bytes) const {
+        if (static_cast<size_t>(end - pos) < bytes) {
+            throw std::runtime_error("Truncated compressed map data");
+        }
+    }
+    
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            require(1);
+            unsigned char byte = *pos++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        throw std::runtime_error("Corrupt varint in compressed map data");
+    }
+    
+    template <typename T>
+    T raw() {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+};
+
+// Move pos forward to the first byte after a newline (or to end)
+inline const char* alignToLineStart(const char* pos, const char* begin, const char* end) {
+    if (pos <= begin || pos >= end || pos[-1] == '\n') return pos;
+    const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    return newline ? newline + 1 : end;
+}
+
+}
+
+MapParser::MapParser() : generationSeed(0), hasGenerationSeed(false) {
+    buildDecodeTables();
+}
+
+void MapParser::buildDecodeTables() {
+    for (int c = 0; c < 256; c++) {
+        TerrainType type = charToTerrainType(static_cast<char>(c));
+        typeTable[c] = type;
+        elevationTable[c] = defaultElevation(type);
+        windTable[c] = defaultWindResistance(type);
+    }
+}
+
+double MapParser::defaultElevation(TerrainType type) const {
+    return type == TerrainType::HILL ? 3.0 : 0.0;
+}
+
+double MapParser::defaultWindResistance(TerrainType type) const {
+    return type == TerrainType::WIND_ZONE ? 2.0 : 0.0;
+}
+
+void MapParser::decodeRow(const char* row, Terrain& terrain, int y) const {
+    size_t offset = terrain.index(0, y);
+    TerrainType* types = terrain.grid.data() + offset;
+    double* elevation = terrain.elevationMap.data() + offset;
+    double* wind = terrain.windResistance.data() + offset;
+    const unsigned char* chars = reinterpret_cast<const unsigned char*>(row);
+    
+    for (int x = 0; x < terrain.getWidth(); x++) {
+        unsigned char c = chars[x];
+        types[x] = typeTable[c];
+        elevation[x] = elevationTable[c];
+        wind[x] = windTable[c];
+    }
+}
 
-MapParser::MapParser() {}
 
 TerrainType MapParser::charToTerrainType(char c) const {
     switch (c) {
@@ -16,6 +150,8 @@ TerrainType MapParser::charToTerrainType(char c) const {
         case 'W': case 'w': return TerrainType::WIND_ZONE;
         case 'S': case 's': return TerrainType::START;
         case 'D': case 'd': return TerrainType::END;
+        case 'E': case 'e': return TerrainType::ENERGY_STATION;
+        case 'X': case 'x': return TerrainType::DANGER_ZONE;
         default: return TerrainType::NORMAL;
     }
 }
@@ -28,6 +164,8 @@ char MapParser::terrainTypeToChar(TerrainType type) const {
         case TerrainType::WIND_ZONE: return 'W';
         case TerrainType::START: return 'S';
         case TerrainType::END: return 'D';
+        case TerrainType::ENERGY_STATION: return 'E';
+        case TerrainType::DANGER_ZONE: return 'X';
         default: return '.';
     }
 }
@@ -37,70 +175,505 @@ bool MapParser::isValidMapFile(const std::string& filename) const {
     return file.good();
 }
 
+bool MapParser::isBinaryMapFile(const std::string& filename) const {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(UAVMAP_MAGIC)];
+    if (!file.read(magic, sizeof(magic))) {
+        return false;
+    }
+    return hasUavMapMagic(magic, sizeof(magic));
+}
+
 Terrain MapParser::loadMap(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open map file: " + filename);
+    if (filename == "-") {
+        return loadMapStream(std::cin);
     }
     
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    file.close();
+    // Binary maps are detected by their magic, whatever the extension
+    if (isBinaryMapFile(filename)) {
+        return loadBinary(filename);
+    }
     
-    return loadMapFromString(content);
+    // Parse the text straight out of the mapping, without a string copy
+    MappedFile file(filename);
+    if (hasUavRleMagic(file.data(), file.size())) {
+        return decodeCompressed(file.data(), file.size());
+    }
+    return parseMapBuffer(file.data(), file.size());
 }
 
 Terrain MapParser::loadMapFromString(const std::string& mapData) {
-    std::vector<std::string> lines = parseMapLines(mapData);
+    return parseMapBuffer(mapData.data(), mapData.size());
+}
+
+Terrain MapParser::parseMapBuffer(const char* data, size_t size, unsigned threads) const {
+    const char* pos = data;
+    const char* end = data + size;
     
-    if (lines.empty()) {
+    RowSpan first;
+    if (!nextRow(pos, end, first)) {
         throw std::runtime_error("Empty map data");
     }
     
-    if (!validateMapDimensions(lines)) {
-        throw std::runtime_error("Invalid map dimensions - all rows must have same length");
+    if (first.length > static_cast<size_t>(INT32_MAX)) {
+        throw std::runtime_error("Map dimensions too large");
     }
+    const int width = static_cast<int>(first.length);
+    const char* body = first.begin;
     
-    int height = lines.size();
-    int width = lines[0].length();
+    if (threads == 0) {
+        threads = size >= PARALLEL_PARSE_THRESHOLD ? defaultThreadCount() : 1;
+    }
     
-    Terrain terrain(width, height);
+    if (threads <= 1) {
+        // Every row is at least width + 1 bytes apart, which bounds the
+        // height up front; decode in one pass and trim the tail afterwards
+        size_t maxRows = (static_cast<size_t>(end - body) + 1) / (static_cast<size_t>(width) + 1);
+        if (maxRows > static_cast<size_t>(INT32_MAX)) {
+            throw std::runtime_error("Map dimensions too large");
+        }
+        Terrain terrain(width, static_cast<int>(maxRows), costProfile);
+        
+        RowSpan row = first;
+        int y = 0;
+        do {
+            if (static_cast<int>(row.length) != width) {
+                throw std::runtime_error("Invalid map dimensions - all rows must have same length");
+            }
+            decodeRow(row.begin, terrain, y++);
+        } while (nextRow(pos, end, row));
+        
+        terrain.resizeRows(y);
+        terrain.rebuildCostLayer();
+        return terrain;
+    }
     
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            if (x < static_cast<int>(lines[y].length())) {
-                TerrainType type = charToTerrainType(lines[y][x]);
-                terrain.setTerrain(x, y, type);
-                
-                // Set additional properties based on terrain type
-                switch (type) {
-                    case TerrainType::HILL:
-                        terrain.setElevation(x, y, 3.0);
-                        break;
-                    case TerrainType::WIND_ZONE:
-                        terrain.setWindResistance(x, y, 2.0);
-                        break;
-                    default:
-                        break;
-                }
+    // Parallel path: chunk the buffer on line boundaries, count and validate
+    // rows per chunk, then decode every chunk into its own row range
+    size_t bodySize = end - body;
+    std::vector<size_t> rowCounts(threads, 0);
+    auto chunkBounds = [&](size_t lo, size_t hi, const char*& chunkBegin, const char*& chunkEnd) {
+        chunkBegin = alignToLineStart(body + lo, body, end);
+        chunkEnd = alignToLineStart(body + hi, body, end);
+    };
+    
+    parallelFor(0, bodySize, threads, [&](size_t lo, size_t hi, unsigned chunk) {
+        const char* chunkPos;
+        const char* chunkEnd;
+        chunkBounds(lo, hi, chunkPos, chunkEnd);
+        
+        RowSpan row;
+        size_t rows = 0;
+        while (nextRow(chunkPos, chunkEnd, row)) {
+            if (static_cast<int>(row.length) != width) {
+                throw std::runtime_error("Invalid map dimensions - all rows must have same length");
+            }
+            rows++;
+        }
+        rowCounts[chunk] = rows;
+    });
+    
+    std::vector<size_t> firstRow(threads, 0);
+    size_t totalRows = 0;
+    for (unsigned chunk = 0; chunk < threads; chunk++) {
+        firstRow[chunk] = totalRows;
+        totalRows += rowCounts[chunk];
+    }
+    if (totalRows > static_cast<size_t>(INT32_MAX)) {
+        throw std::runtime_error("Map dimensions too large");
+    }
+    
+    Terrain terrain(width, static_cast<int>(totalRows), costProfile);
+    
+    parallelFor(0, bodySize, threads, [&](size_t lo, size_t hi, unsigned chunk) {
+        const char* chunkPos;
+        const char* chunkEnd;
+        chunkBounds(lo, hi, chunkPos, chunkEnd);
+        
+        RowSpan row;
+        int y = static_cast<int>(firstRow[chunk]);
+        while (nextRow(chunkPos, chunkEnd, row)) {
+            decodeRow(row.begin, terrain, y++);
+        }
+    });
+    
+    terrain.rebuildCostLayer();
+    return terrain;
+}
+
+template <typename Reader>
+Terrain MapParser::streamRows(Reader read, int heightHint) const {
+    std::vector<char> chunk(STREAM_CHUNK_SIZE);
+    std::string pending; // Partial row carried across chunk boundaries
+    Terrain terrain(0, 0, costProfile);
+    int width = -1;
+    int y = 0;
+    
+    auto acceptRow = [&](const char* row, size_t length) {
+        if (length > 0 && row[length - 1] == '\r') {
+            length--;
+        }
+        if (length == 0) return;
+        if (length > static_cast<size_t>(INT32_MAX) || y == INT32_MAX) {
+            throw std::runtime_error("Map dimensions too large");
+        }
+        
+        if (width < 0) {
+            width = static_cast<int>(length);
+            terrain = Terrain(width, 0, costProfile);
+            terrain.reserveRows(heightHint);
+            pending.reserve(width + 1);
+        } else if (static_cast<int>(length) != width) {
+            throw std::runtime_error("Invalid map dimensions - all rows must have same length");
+        }
+        
+        terrain.resizeRows(y + 1);
+        decodeRow(row, terrain, y++);
+    };
+    
+    size_t got;
+    while ((got = read(chunk.data(), chunk.size())) > 0) {
+        const char* pos = chunk.data();
+        const char* end = pos + got;
+        
+        while (pos < end) {
+            const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+            if (newline == nullptr) {
+                pending.append(pos, end);
+                break;
             }
+            
+            if (pending.empty()) {
+                acceptRow(pos, newline - pos);
+            } else {
+                pending.append(pos, newline);
+                acceptRow(pending.data(), pending.size());
+                pending.clear();
+            }
+            pos = newline + 1;
         }
+        
+        // A carried row longer than width + '\r' can never be valid
+        if (width >= 0 && pending.size() > static_cast<size_t>(width) + 1) {
+            throw std::runtime_error("Invalid map dimensions - all rows must have same length");
+        }
+    }
+    
+    if (!pending.empty()) {
+        acceptRow(pending.data(), pending.size());
+    }
+    
+    if (width < 0) {
+        throw std::runtime_error("Empty map data");
     }
     
+    // Layers grown row by row (or past a short hint) keep spare capacity
+    terrain.trimRows();
+    terrain.rebuildCostLayer();
     return terrain;
 }
 
+Terrain MapParser::loadMapStream(std::istream& input, int heightHint) const {
+    return streamRows([&input](char* buffer, size_t size) -> size_t {
+        input.read(buffer, size);
+        if (input.bad()) {
+            throw std::runtime_error("Error reading map stream");
+        }
+        return static_cast<size_t>(input.gcount());
+    }, heightHint);
+}
+
+Terrain MapParser::loadMapFromFd(int fd, int heightHint) const {
+    return streamRows([fd](char* buffer, size_t size) -> size_t {
+        while (true) {
+#ifdef _WIN32
+            int got = ::_read(fd, buffer, static_cast<unsigned>(size));
+#else
+            ssize_t got = ::read(fd, buffer, size);
+#endif
+            if (got >= 0) return static_cast<size_t>(got);
+            if (errno != EINTR) {
+                throw std::runtime_error("Error reading map from file descriptor");
+            }
+        }
+    }, heightHint);
+}
+
+QuadTerrain MapParser::loadQuadTerrain(const std::string& filename, double quantum) const {
+    if (isBinaryMapFile(filename)) {
+        return QuadTerrain(Terrain::fromBinaryFile(filename, costProfile), quantum);
+    }
+    
+    MappedFile file(filename);
+    if (hasUavRleMagic(file.data(), file.size())) {
+        return QuadTerrain(decodeCompressed(file.data(), file.size()), quantum);
+    }
+    
+    // First pass: dimensions only
+    const char* pos = file.data();
+    const char* end = pos + file.size();
+    RowSpan row;
+    size_t width = 0;
+    size_t height = 0;
+    while (nextRow(pos, end, row)) {
+        if (height == 0) {
+            width = row.length;
+        } else if (row.length != width) {
+            throw std::runtime_error("Invalid map dimensions - all rows must have same length");
+        }
+        height++;
+    }
+    if (height == 0) {
+        throw std::runtime_error("Empty map data");
+    }
+    if (width > static_cast<size_t>(INT32_MAX) || height > static_cast<size_t>(INT32_MAX)) {
+        throw std::runtime_error("Map dimensions too large");
+    }
+    
+    // Second pass: the tree asks for the rows in order
+    pos = file.data();
+    return QuadTerrain(static_cast<int>(width), static_cast<int>(height), costProfile,
+                       [&](int, TerrainType* types, double* elevation, double* wind) {
+                           RowSpan next;
+                           if (!nextRow(pos, end, next)) {
+                               throw std::runtime_error("Map file changed while loading: " + filename);
+                           }
+                           const unsigned char* chars = reinterpret_cast<const unsigned char*>(next.begin);
+                           for (size_t x = 0; x < width; x++) {
+                               types[x] = typeTable[chars[x]];
+                               elevation[x] = elevationTable[chars[x]];
+                               wind[x] = windTable[chars[x]];
+                           }
+                       }, quantum);
+}
+
 bool MapParser::saveMap(const Terrain& terrain, const std::string& filename) const {
     std::ofstream file(filename);
     if (!file.is_open()) {
         return false;
     }
-    
+
     file << terrainToString(terrain);
     file.close();
     return true;
 }
 
+Terrain MapParser::loadBinary(const std::string& filename) {
+    return Terrain::fromBinaryFile(filename, costProfile);
+}
+
+bool MapParser::saveBinary(const Terrain& terrain, const std::string& filename) const {
+    // The file format is always row-major with full-precision layers
+    if (terrain.getLayout() != CellLayout::ROW_MAJOR || terrain.getEncoding() != CellEncoding::FULL) {
+        Terrain rowMajor = terrain;
+        rowMajor.setLayout(CellLayout::ROW_MAJOR);
+        rowMajor.setEncoding(CellEncoding::FULL);
+        return saveBinary(rowMajor, filename);
+    }
+    
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    UavMapHeader header = makeUavMapHeader(terrain.getWidth(), terrain.getHeight());
+    header.costFingerprint = terrain.getCostProfile().fingerprint();
+    header.minCellCost = terrain.getMinCellCost();
+    size_t cells = static_cast<size_t>(terrain.getWidth()) * terrain.getHeight();
+    const char zeros[UAVMAP_ALIGNMENT] = {};
+    uint64_t written = 0;
+    
+    auto writeAt = [&](uint64_t offset, const void* data, size_t bytes) {
+        file.write(zeros, offset - written); // Alignment padding
+        file.write(static_cast<const char*>(data), bytes);
+        written = offset + bytes;
+    };
+    
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.typeOffset, terrain.terrainData(), cells * sizeof(TerrainType));
+    writeAt(header.elevationOffset, terrain.elevationData(), cells * sizeof(double));
+    writeAt(header.windOffset, terrain.windData(), cells * sizeof(double));
+    writeAt(header.costOffset, terrain.costData(), cells * sizeof(double));
+    
+    return file.good();
+}
+
+bool MapParser::convertToBinary(const std::string& textFile, const std::string& binaryFile) {
+    Terrain terrain = loadMap(textFile);
+    return saveBinary(terrain, binaryFile);
+}
+
+std::string MapParser::encodeCompressed(const Terrain& terrain) const {
+    if (terrain.getLayout() != CellLayout::ROW_MAJOR || terrain.getEncoding() != CellEncoding::FULL) {
+        Terrain rowMajor = terrain;
+        rowMajor.setLayout(CellLayout::ROW_MAJOR);
+        rowMajor.setEncoding(CellEncoding::FULL);
+        return encodeCompressed(rowMajor);
+    }
+    
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const TerrainType* types = terrain.terrainData();
+    
+    std::string out(UAVRLE_MAGIC, sizeof(UAVRLE_MAGIC));
+    uint32_t dims[3] = {UAVRLE_VERSION, static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+    out.append(reinterpret_cast<const char*>(dims), sizeof(dims));
+    
+    std::string runs;
+    for (int y = 0; y < height; y++) {
+        const TerrainType* row = types + terrain.index(0, y);
+        runs.clear();
+        uint64_t runCount = 0;
+        
+        for (int x = 0; x < width;) {
+            int runEnd = x + 1;
+            while (runEnd < width && row[runEnd] == row[x]) runEnd++;
+            runs.push_back(static_cast<char>(row[x]));
+            writeVarint(runs, runEnd - x);
+            runCount++;
+            x = runEnd;
+        }
+        
+        writeVarint(out, runCount);
+        out += runs;
+    }
+    
+    // Sparse overrides for values the type default does not reproduce
+    auto writeSparse = [&](const double* values, double (MapParser::*defaultFor)(TerrainType) const) {
+        size_t cells = static_cast<size_t>(width) * height;
+        std::string entries;
+        uint64_t count = 0;
+        size_t previous = 0;
+        
+        for (size_t i = 0; i < cells; i++) {
+            if (values[i] != (this->*defaultFor)(types[i])) {
+                writeVarint(entries, i - previous);
+                entries.append(reinterpret_cast<const char*>(&values[i]), sizeof(double));
+                previous = i;
+                count++;
+            }
+        }
+        
+        writeVarint(out, count);
+        out += entries;
+    };
+    
+    writeSparse(terrain.elevationData(), &MapParser::defaultElevation);
+    writeSparse(terrain.windData(), &MapParser::defaultWindResistance);
+    
+    return out;
+}
+
+Terrain MapParser::decodeCompressed(const char* data, size_t size) const {
+    if (!hasUavRleMagic(data, size)) {
+        throw std::runtime_error("Not a compressed UAV map");
+    }
+    
+    ByteReader in{reinterpret_cast<const unsigned char*>(data) + sizeof(UAVRLE_MAGIC),
+                  reinterpret_cast<const unsigned char*>(data) + size};
+    uint32_t version = in.raw<uint32_t>();
+    uint32_t width = in.raw<uint32_t>();
+    uint32_t height = in.raw<uint32_t>();
+    
+    if (version != UAVRLE_VERSION) {
+        throw std::runtime_error("Unsupported compressed map version");
+    }
+    if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX) {
+        throw std::runtime_error("Invalid compressed map dimensions");
+    }
+    // Two 32-bit sides cannot overflow the product, but the layers must
+    // still be addressable
+    uint64_t cells = static_cast<uint64_t>(width) * height;
+    if (cells > std::numeric_limits<size_t>::max() / sizeof(double)) {
+        throw std::runtime_error("Invalid compressed map dimensions");
+    }
+    
+    // Check every run before allocating, so the header cannot claim more
+    // cells than the rows describe
+    ByteReader rows = in;
+    for (uint32_t y = 0; y < height; y++) {
+        uint64_t runCount = rows.varint();
+        if (runCount == 0 || runCount > width) {
+            throw std::runtime_error("Invalid map dimensions - all rows must have same length");
+        }
+        
+        uint64_t x = 0;
+        for (uint64_t r = 0; r < runCount; r++) {
+            uint8_t typeByte = rows.raw<uint8_t>();
+            uint64_t length = rows.varint();
+            if (!isTerrainTypeByte(typeByte)) {
+                throw std::runtime_error("Invalid terrain type in compressed map");
+            }
+            // x <= width, so this cannot wrap
+            if (length == 0 || length > width - x) {
+                throw std::runtime_error("Compressed map run overflows its row");
+            }
+            x += length;
+        }
+        
+        if (x != width) {
+            throw std::runtime_error("Invalid map dimensions - all rows must have same length");
+        }
+    }
+    
+    Terrain terrain(static_cast<int>(width), static_cast<int>(height), costProfile);
+    TerrainType* types = terrain.grid.data();
+    double* elevation = terrain.elevationMap.data();
+    double* wind = terrain.windResistance.data();
+    
+    // Expand each run with block fills; elevation and wind start from the
+    // per-type defaults and the sparse lists patch the exceptions
+    for (uint32_t y = 0; y < height; y++) {
+        size_t offset = terrain.index(0, y);
+        uint64_t runCount = in.varint();
+        for (uint64_t r = 0; r < runCount; r++) {
+            uint8_t typeByte = in.raw<uint8_t>();
+            uint64_t length = in.varint();
+            TerrainType type = static_cast<TerrainType>(typeByte);
+            std::memset(types + offset, typeByte, length);
+            std::fill_n(elevation + offset, length, defaultElevation(type));
+            std::fill_n(wind + offset, length, defaultWindResistance(type));
+            offset += length;
+        }
+    }
+    
+    for (double* values : {elevation, wind}) {
+        uint64_t count = in.varint();
+        if (count > cells) {
+            throw std::runtime_error("Compressed map override outside the grid");
+        }
+        uint64_t cell = 0;
+        for (uint64_t i = 0; i < count; i++) {
+            // cell < cells, so checking the gap left keeps cell + delta from wrapping
+            uint64_t delta = in.varint();
+            if (delta >= cells - cell) {
+                throw std::runtime_error("Compressed map override outside the grid");
+            }
+            cell += delta;
+            values[cell] = in.raw<double>();
+        }
+    }
+    
+    terrain.rebuildCostLayer();
+    return terrain;
+}
+
+bool MapParser::saveCompressed(const Terrain& terrain, const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    std::string encoded = encodeCompressed(terrain);
+    file.write(encoded.data(), encoded.size());
+    return file.good();
+}
+
+Terrain MapParser::loadCompressed(const std::string& filename) const {
+    MappedFile file(filename);
+    return decodeCompressed(file.data(), file.size());
+}
+
 std::string MapParser::terrainToString(const Terrain& terrain) const {
     std::stringstream ss;
     
@@ -149,11 +722,21 @@ bool MapParser::validateMapDimensions(const std::vector<std::string>& lines) con
 
 Terrain MapParser::generateRandomMap(int width, int height, double obstacleRatio, 
                                    double hillRatio, double windRatio) {
-    Terrain terrain(width, height);
+    if (hasGenerationSeed) {
+        return generateRandomMap(width, height, obstacleRatio, hillRatio, windRatio, generationSeed);
+    }
+    Terrain terrain(width, height, costProfile);
     terrain.generateRandomTerrain(obstacleRatio, hillRatio, windRatio);
     return terrain;
 }
 
+Terrain MapParser::generateRandomMap(int width, int height, double obstacleRatio,
+                                   double hillRatio, double windRatio, uint64_t seed) {
+    Terrain terrain(width, height, costProfile);
+    terrain.generateRandomTerrain(obstacleRatio, hillRatio, windRatio, seed);
+    return terrain;
+}
+
 Terrain MapParser::createSampleMap() {
     std::string sampleMapData = 
         "...........\n"
@@ -190,38 +773,87 @@ Terrain MapParser::createComplexMap() {
     return loadMapFromString(complexMapData);
 }
 
-bool MapParser::loadConfiguration(const std::string& configFile) {
-    std::ifstream file(configFile);
-    if (!file.is_open()) {
-        std::cout << "Warning: Could not load configuration file: " << configFile << "\n";
+bool MapParser::loadConfiguration(const std::string& configFile, bool verbose) {
+    // Nothing is applied until every value has been read and checked, so a
+    // bad file leaves the defaults in place
+    CostProfile profile;
+    bool hasSeed = false;
+    uint64_t seed = 0;
+    try {
+        if (!config.loadFile(configFile)) {
+            if (verbose) {
+                std::cout << "Warning: Could not load configuration file: " << configFile << "\n";
+            }
+            return false;
+        }
+        profile = loadCostProfile(config);
+        hasSeed = config.has("map_generation.seed");
+        if (hasSeed) {
+            seed = config.getUnsigned("map_generation.seed", 0);
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Warning: Invalid configuration file " << configFile << ": " << e.what()
+                  << "; using defaults\n";
         return false;
     }
     
-    // Simple JSON-like parsing for basic configuration
-    std::string line;
-    while (std::getline(file, line)) {
-        // Skip comments and empty lines
-        if (line.empty() || line[0] == '#' || line[0] == '/') continue;
-        
-        // Basic key-value parsing
-        size_t colonPos = line.find(':');
-        if (colonPos != std::string::npos) {
-            std::string key = line.substr(0, colonPos);
-            std::string value = line.substr(colonPos + 1);
-            
-            // Remove whitespace
-            key.erase(std::remove_if(key.begin(), key.end(), ::isspace), key.end());
-            value.erase(std::remove_if(value.begin(), value.end(), ::isspace), value.end());
-            
-            // Remove quotes
-            if (value.front() == '"' && value.back() == '"') {
-                value = value.substr(1, value.length() - 2);
-            }
-            
-            std::cout << "Config: " << key << " = " << value << "\n";
+    if (verbose) {
+        for (const auto& entry : config.entries()) {
+            std::cout << "Config: " << entry.first << " = " << entry.second << "\n";
         }
     }
     
-    file.close();
+    costProfile = profile;
+    if (hasSeed) {
+        setGenerationSeed(seed);
+    }
     return true;
 }
+
+CostProfile MapParser::loadCostProfile(const JsonConfig& settings) const {
+    // Keys under "terrain_costs"; anything missing keeps its default
+    CostProfile profile;
+    const std::string prefix = "terrain_costs.";
+    
+    // Every cell must cost more than zero for A*'s minCellCost heuristic;
+    // factors may be zero, which switches their term off
+    auto read = [&](const char* key, double fallback, bool allowZero) {
+        double value = settings.getNumber(prefix + key, fallback);
+        if (!std::isfinite(value) || value < 0.0 || (value == 0.0 && !allowZero)) {
+            throw std::runtime_error(std::string("Config value for ") + prefix + key +
+                                     (allowZero ? " must be finite and not negative"
+                                                : " must be finite and positive"));
+        }
+        return value;
+    };
+    
+    struct TypeKey {
+        const char* key;
+        TerrainType type;
+    };
+    const TypeKey typeKeys[] = {
+        {"normal_cost", TerrainType::NORMAL},
+        {"hill_cost", TerrainType::HILL},
+        {"wind_cost", TerrainType::WIND_ZONE},
+        {"start_cost", TerrainType::START},
+        {"end_cost", TerrainType::END},
+        {"energy_station_cost", TerrainType::ENERGY_STATION},
+        {"danger_zone_cost", TerrainType::DANGER_ZONE},
+    };
+    
+    // START/END cells cost the same as NORMAL unless configured otherwise
+    double normalCost = read("normal_cost", profile.getTypeCost(TerrainType::NORMAL), false);
+    profile.setTypeCost(TerrainType::START, normalCost);
+    profile.setTypeCost(TerrainType::END, normalCost);
+    
+    for (const TypeKey& entry : typeKeys) {
+        profile.setTypeCost(entry.type, read(entry.key, profile.getTypeCost(entry.type), false));
+    }
+    
+    profile.obstacleCost = read("obstacle_cost", profile.obstacleCost, false);
+    profile.elevationFactor = read("elevation_factor", profile.elevationFactor, true);
+    profile.windFactor = read("wind_resistance_factor", profile.windFactor, true);
+    profile.headwindFactor = read("headwind_factor", profile.headwindFactor, true);
+    profile.minWindScale = read("min_wind_scale", profile.minWindScale, false);
+    return profile;
+}
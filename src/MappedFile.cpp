@@ -0,0 +1,61 @@
+#include "../include/MappedFile.h"
+#include <stdexcept>
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+
+MappedFile::MappedFile(const std::string& filename) : base(nullptr), length(0) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open map file: " + filename);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not stat map file: " + filename);
+    }
+    length = static_cast<size_t>(info.st_size);
+
+    if (length > 0) {
+        void* addr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Could not map file: " + filename);
+        }
+        base = static_cast<char*>(addr);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (base != nullptr) {
+        ::munmap(base, length);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) : base(nullptr), length(0) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open map file: " + filename);
+    }
+
+    buffer.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    base = buffer.data();
+    length = buffer.size();
+}
+
+MappedFile::~MappedFile() {}
+
+#endif
@@ -0,0 +1,365 @@
+#include "../include/MissionPlanner.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// 8-directional moves, matching Terrain::getNeighbors
+static const int* const NEIGHBOR_DX = Terrain::DIRECTION_DX;
+static const int* const NEIGHBOR_DY = Terrain::DIRECTION_DY;
+static const double NEIGHBOR_DISTANCE[8] = {
+    std::sqrt(2.0), 1.0, std::sqrt(2.0), 1.0, 1.0, std::sqrt(2.0), 1.0, std::sqrt(2.0)
+};
+
+// Smallest tour change worth making; anything less is rounding
+static const double MIN_GAIN = 1e-9;
+
+namespace {
+
+// Costs between tour stops: stop 0 is the base, 1..n the waypoints, and
+// n + 1 the end of the mission, reached from any stop by flying home, or
+// for free when the mission ends in the field
+struct TourCosts {
+    const std::vector<std::vector<double>>& matrix;
+    bool returnToBase;
+
+    size_t end() const { return matrix.size(); }
+    double operator()(size_t from, size_t to) const {
+        if (to == end()) return returnToBase ? matrix[from][0] : 0.0;
+        return matrix[from][to];
+    }
+};
+
+// Tour from the base to the end stop through every waypoint. The next
+// stop added is the one nearest to the tour so far, in either direction,
+// at the position where it adds the least.
+std::vector<size_t> nearestInsertion(const TourCosts& cost) {
+    const size_t n = cost.end() - 1;
+    const double unreachable = std::numeric_limits<double>::infinity();
+    std::vector<size_t> tour = {0, cost.end()};
+    std::vector<double> nearest(n + 1, unreachable);
+    std::vector<bool> inTour(n + 1, false);
+    inTour[0] = true;
+
+    size_t added = 0;
+    for (size_t step = 0; step < n; step++) {
+        for (size_t stop = 1; stop <= n; stop++) {
+            if (!inTour[stop]) {
+                nearest[stop] = std::min(nearest[stop], std::min(cost(added, stop), cost(stop, added)));
+            }
+        }
+        size_t next = 0;
+        for (size_t stop = 1; stop <= n; stop++) {
+            if (!inTour[stop] && (next == 0 || nearest[stop] < nearest[next])) next = stop;
+        }
+
+        size_t bestPosition = 1;
+        double bestIncrease = unreachable;
+        for (size_t i = 0; i + 1 < tour.size(); i++) {
+            double increase = cost(tour[i], next) + cost(next, tour[i + 1]) - cost(tour[i], tour[i + 1]);
+            if (increase < bestIncrease) {
+                bestIncrease = increase;
+                bestPosition = i + 1;
+            }
+        }
+        tour.insert(tour.begin() + bestPosition, next);
+        inTour[next] = true;
+        added = next;
+    }
+    return tour;
+}
+
+// Prefix sums along the tour: forward[i] is the cost of reaching tour[i];
+// backward[i] the same over waypoint legs flown in reverse, so the cost of
+// any reversed stretch of waypoints is one subtraction
+void tourPrefixes(const std::vector<size_t>& tour, const TourCosts& cost,
+                  std::vector<double>& forward, std::vector<double>& backward) {
+    forward.assign(tour.size(), 0.0);
+    backward.assign(tour.size(), 0.0);
+    for (size_t i = 1; i < tour.size(); i++) {
+        forward[i] = forward[i - 1] + cost(tour[i - 1], tour[i]);
+        bool waypoints = i >= 2 && i + 1 < tour.size();
+        backward[i] = backward[i - 1] + (waypoints ? cost(tour[i], tour[i - 1]) : 0.0);
+    }
+}
+
+// One pass of 2-opt: reverse tour[i..j] wherever that is cheaper. The
+// costs are asymmetric, so the reversed stretch is priced from backward.
+bool improveTwoOpt(std::vector<size_t>& tour, const TourCosts& cost) {
+    std::vector<double> forward, backward;
+    tourPrefixes(tour, cost, forward, backward);
+    bool improved = false;
+    for (size_t i = 1; i + 2 < tour.size(); i++) {
+        for (size_t j = i + 1; j + 1 < tour.size(); j++) {
+            double before = cost(tour[i - 1], tour[i]) + (forward[j] - forward[i]) + cost(tour[j], tour[j + 1]);
+            double after = cost(tour[i - 1], tour[j]) + (backward[j] - backward[i]) + cost(tour[i], tour[j + 1]);
+            if (after < before - MIN_GAIN) {
+                std::reverse(tour.begin() + i, tour.begin() + j + 1);
+                tourPrefixes(tour, cost, forward, backward);
+                improved = true;
+            }
+        }
+    }
+    return improved;
+}
+
+// One pass of Or-opt: move a stretch of one to three waypoints, either
+// way round, to wherever it is cheapest
+bool improveOrOpt(std::vector<size_t>& tour, const TourCosts& cost) {
+    std::vector<double> forward, backward;
+    tourPrefixes(tour, cost, forward, backward);
+    bool improved = false;
+    for (size_t length = 1; length <= 3; length++) {
+        for (size_t i = 1; i + length < tour.size(); i++) {
+            size_t first = tour[i];
+            size_t last = tour[i + length - 1];
+            double inside = forward[i + length - 1] - forward[i];
+            double reversed = backward[i + length - 1] - backward[i];
+            double removed = cost(tour[i - 1], first) + inside + cost(last, tour[i + length]) -
+                             cost(tour[i - 1], tour[i + length]);
+
+            size_t bestGap = 0;
+            bool bestReversed = false;
+            double bestGain = MIN_GAIN;
+            for (size_t gap = 0; gap + 1 < tour.size(); gap++) {
+                if (gap + 1 >= i && gap < i + length) continue; // Touches the stretch itself
+                double edge = cost(tour[gap], tour[gap + 1]);
+                double ahead = cost(tour[gap], first) + inside + cost(last, tour[gap + 1]) - edge;
+                double back = cost(tour[gap], last) + reversed + cost(first, tour[gap + 1]) - edge;
+                if (removed - ahead > bestGain) {
+                    bestGain = removed - ahead;
+                    bestGap = gap;
+                    bestReversed = false;
+                }
+                if (removed - back > bestGain) {
+                    bestGain = removed - back;
+                    bestGap = gap;
+                    bestReversed = true;
+                }
+            }
+            if (bestGain <= MIN_GAIN) continue;
+
+            std::vector<size_t> stretch(tour.begin() + i, tour.begin() + i + length);
+            if (bestReversed) std::reverse(stretch.begin(), stretch.end());
+            tour.erase(tour.begin() + i, tour.begin() + i + length);
+            size_t at = bestGap < i ? bestGap + 1 : bestGap + 1 - length;
+            tour.insert(tour.begin() + at, stretch.begin(), stretch.end());
+            tourPrefixes(tour, cost, forward, backward);
+            improved = true;
+        }
+    }
+    return improved;
+}
+
+} // namespace
+
+MissionPlanner::MissionPlanner(const Terrain& terrainRef, unsigned threadCount)
+    : terrain(terrainRef), threads(threadCount) {}
+
+void MissionPlanner::reachTargets(const Point& origin, const TargetSet& targets, bool forward, SearchWorkspace& ws,
+                                  std::vector<double>& costs) const {
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const uint32_t originCell = static_cast<uint32_t>(terrain.cellIndex(origin.x, origin.y));
+    size_t remaining = targets.cells;
+
+    // Cheapest possible flight to the nearest point of the box: consistent,
+    // and zero inside it
+    auto heuristic = [&](int x, int y) {
+        Point nearest(std::min(std::max(x, targets.low.x), targets.high.x),
+                      std::min(std::max(y, targets.low.y), targets.high.y));
+        return terrain.getHeuristicCost(Point(x, y), nearest);
+    };
+
+    ws.prepare(terrain.cellCount());
+    ws.visit(originCell, 0.0, SearchWorkspace::NO_PARENT);
+    double originH = heuristic(origin.x, origin.y);
+    ws.push(OpenEntry{originH, originH, origin.x, origin.y});
+
+    while (!ws.openList.empty() && remaining > 0) {
+        OpenEntry current = ws.pop();
+        uint32_t cell = static_cast<uint32_t>(terrain.cellIndex(current.x, current.y));
+        double g = ws.gScore[cell];
+        if (current.fCost > g + current.hCost) continue;
+
+        if (targets.firstTarget[cell] != NO_TARGET) {
+            for (uint32_t target = targets.firstTarget[cell]; target != NO_TARGET; target = targets.nextTarget[target]) {
+                costs[target] = g;
+            }
+            remaining--;
+        }
+        // Backward, an obstacle cannot be entered, so nothing comes from it
+        if (!forward && terrain.cellType(cell) == TerrainType::OBSTACLE) continue;
+
+        // Forward, a move costs the cell it enters; backward, every move
+        // into this cell costs the same
+        double rate = forward ? 0.0 : terrain.cellCost(cell);
+        for (int d = 0; d < 8; d++) {
+            int nx = current.x + NEIGHBOR_DX[d];
+            int ny = current.y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+
+            // Backward, an obstacle target may still be flown out of
+            size_t next = terrain.cellIndex(nx, ny);
+            if (terrain.cellType(next) == TerrainType::OBSTACLE &&
+                (forward || targets.firstTarget[next] == NO_TARGET)) continue;
+
+            double tentative = g + (forward ? terrain.cellCost(next) : rate) * NEIGHBOR_DISTANCE[d];
+            if (!ws.seen(next) || tentative < ws.gScore[next]) {
+                ws.visit(next, tentative, cell);
+                double hCost = heuristic(nx, ny);
+                ws.push(OpenEntry{tentative + hCost, hCost, nx, ny});
+            }
+        }
+    }
+}
+
+std::vector<std::vector<double>> MissionPlanner::costMatrix(const std::vector<Point>& sources,
+                                                            const std::vector<Point>& targets) const {
+    // Search from the smaller side: forward from each source, or backward
+    // from each target when there are fewer targets
+    const bool forward = sources.size() <= targets.size();
+    const std::vector<Point>& origins = forward ? sources : targets;
+    const std::vector<Point>& reached = forward ? targets : sources;
+    if (reached.size() >= NO_TARGET) {
+        throw std::runtime_error("Too many points for the cost matrix");
+    }
+    const double unreachable = std::numeric_limits<double>::infinity();
+    std::vector<std::vector<double>> matrix(sources.size(), std::vector<double>(targets.size(), unreachable));
+
+    // Points sharing a cell are chained, so each search settles a cell once
+    TargetSet set;
+    set.firstTarget.assign(terrain.cellCount(), NO_TARGET);
+    set.nextTarget.assign(reached.size(), NO_TARGET);
+    set.low = Point(terrain.getWidth(), terrain.getHeight());
+    set.high = Point(-1, -1);
+    for (size_t i = 0; i < reached.size(); i++) {
+        if (!terrain.isValidPosition(reached[i])) continue;
+        size_t cell = terrain.cellIndex(reached[i].x, reached[i].y);
+        if (set.firstTarget[cell] == NO_TARGET) set.cells++;
+        set.nextTarget[i] = set.firstTarget[cell];
+        set.firstTarget[cell] = static_cast<uint32_t>(i);
+        set.low = Point(std::min(set.low.x, reached[i].x), std::min(set.low.y, reached[i].y));
+        set.high = Point(std::max(set.high.x, reached[i].x), std::max(set.high.y, reached[i].y));
+    }
+
+    // One search per origin; each thread reuses one workspace
+    unsigned workers = threads != 0 ? threads : defaultThreadCount();
+    parallelFor(0, origins.size(), workers, [&](size_t begin, size_t end, unsigned) {
+        SearchWorkspace ws;
+        std::vector<double> column;
+        for (size_t i = begin; i < end; i++) {
+            if (!terrain.isValidPosition(origins[i])) continue;
+            if (forward) {
+                reachTargets(origins[i], set, true, ws, matrix[i]);
+                continue;
+            }
+            column.assign(sources.size(), unreachable);
+            reachTargets(origins[i], set, false, ws, column);
+            for (size_t source = 0; source < sources.size(); source++) {
+                matrix[source][i] = column[source];
+            }
+        }
+    });
+    return matrix;
+}
+
+MissionPlan MissionPlanner::plan(const Point& base, const std::vector<Point>& waypoints, const Drone& drone) const {
+    MissionOptions options;
+    options.energyCapacity = drone.getMaxEnergy() * (1.0 - drone.getReserveFraction());
+    return plan(base, waypoints, options);
+}
+
+MissionPlan MissionPlanner::plan(const Point& base, const std::vector<Point>& waypoints,
+                                 const MissionOptions& options) const {
+    if (!(options.energyCapacity >= 0.0)) {
+        throw std::runtime_error("Mission energy capacity must not be negative");
+    }
+    MissionPlan mission;
+    if (!terrain.isValidPosition(base)) {
+        return mission;
+    }
+
+    // Base first, then the waypoints
+    std::vector<Point> stops;
+    stops.push_back(base);
+    stops.insert(stops.end(), waypoints.begin(), waypoints.end());
+    const std::vector<std::vector<double>> matrix = costMatrix(stops, stops);
+    const TourCosts cost{matrix, options.returnToBase};
+    const size_t n = waypoints.size();
+    const double unreachable = std::numeric_limits<double>::infinity();
+
+    // Every waypoint is reached from the base or none is worth ordering;
+    // the others are then all in the base's component too
+    for (size_t stop = 1; stop <= n; stop++) {
+        if (!(matrix[0][stop] < unreachable) || !(cost(stop, cost.end()) < unreachable)) {
+            return mission;
+        }
+    }
+
+    std::vector<size_t> tour = nearestInsertion(cost);
+    bool improved = true;
+    while (improved) {
+        improved = improveTwoOpt(tour, cost);
+        improved = improveOrOpt(tour, cost) || improved;
+    }
+
+    // Cut the order into sorties. best[j] is the least energy to cover the
+    // first j waypoints in whole sorties; a sortie over waypoints i..j
+    // leaves base, visits them in order, and flies home unless it is the
+    // last one of a mission that ends in the field. Costs obey the
+    // triangle inequality, so a sortie only gets dearer as it starts earlier.
+    std::vector<double> best(n + 1, unreachable);
+    std::vector<size_t> cut(n + 1, 0);
+    best[0] = 0.0;
+    for (size_t j = 1; j <= n; j++) {
+        double inside = 0.0;
+        for (size_t i = j; i >= 1; i--) {
+            if (i < j) inside += matrix[tour[i]][tour[i + 1]];
+            double home = j == n ? cost(tour[j], cost.end()) : matrix[tour[j]][0];
+            double sortie = matrix[0][tour[i]] + inside + home;
+            if (sortie > options.energyCapacity) break;
+            // Ties go to the longer sortie: a landing that saves nothing is not worth making
+            if (best[i - 1] + sortie <= best[j] + MIN_GAIN) {
+                best[j] = best[i - 1] + sortie;
+                cut[j] = i;
+            }
+        }
+    }
+    if (!(best[n] < unreachable)) {
+        return mission; // Some waypoint is out of range even on its own
+    }
+    for (size_t j = n; j > 0; j = cut[j] - 1) {
+        std::vector<size_t> sortie;
+        for (size_t i = cut[j]; i <= j; i++) sortie.push_back(tour[i] - 1);
+        mission.sorties.push_back(sortie);
+    }
+    std::reverse(mission.sorties.begin(), mission.sorties.end());
+
+    // Stitch A* legs: base, each sortie, base between sorties and at the end
+    std::vector<Point> visits;
+    visits.push_back(base);
+    for (size_t s = 0; s < mission.sorties.size(); s++) {
+        for (size_t waypoint : mission.sorties[s]) visits.push_back(waypoints[waypoint]);
+        if (options.returnToBase || s + 1 < mission.sorties.size()) visits.push_back(base);
+    }
+
+    std::vector<std::vector<Point>> legs(visits.size() - 1);
+    unsigned workers = threads != 0 ? threads : defaultThreadCount();
+    parallelFor(0, legs.size(), workers, [&](size_t begin, size_t end, unsigned) {
+        Optimizer optimizer(terrain);
+        for (size_t i = begin; i < end; i++) {
+            legs[i] = optimizer.findPathAStar(visits[i], visits[i + 1]);
+        }
+    });
+
+    mission.path.push_back(base);
+    for (const std::vector<Point>& leg : legs) {
+        if (leg.empty()) {
+            return MissionPlan(); // Cannot happen: the matrix found every leg
+        }
+        mission.path.insert(mission.path.end(), leg.begin() + 1, leg.end());
+    }
+    mission.energy = Optimizer(terrain).calculatePathEnergy(mission.path);
+    return mission;
+}
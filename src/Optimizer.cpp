@@ -1,8 +1,44 @@
 #include "../include/Optimizer.h"
+#include "../include/Parallel.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
 #include <iomanip>
+#include <stdexcept>
+#include <limits>
+#include <set>
+
+// 8-directional moves, matching Terrain::getNeighbors
+static const int* const NEIGHBOR_DX = Terrain::DIRECTION_DX;
+static const int* const NEIGHBOR_DY = Terrain::DIRECTION_DY;
+static const double NEIGHBOR_DISTANCE[8] = {
+    std::sqrt(2.0), 1.0, std::sqrt(2.0), 1.0, 1.0, std::sqrt(2.0), 1.0, std::sqrt(2.0)
+};
+
+// Energy comparison for the energy searches: sums of the same moves taken
+// in another order can differ in the last bits, so energies within
+// rounding of each other count as equal. Energies are never negative.
+static bool energyBelow(double energy, double bound) {
+    return energy < bound * (1.0 - 1e-12) - 1e-12;
+}
+
+void SearchWorkspace::prepare(size_t cells) {
+    if (cells >= NO_PARENT) {
+        throw std::runtime_error("Terrain too large for the search workspace");
+    }
+    if (stamp.size() < cells) {
+        gScore.resize(cells);
+        parent.resize(cells);
+        stamp.resize(cells, 0);
+    }
+    
+    openList.clear();
+    if (++generation == 0) {
+        // Stamp counter wrapped: forget every old entry once
+        std::fill(stamp.begin(), stamp.end(), 0);
+        generation = 1;
+    }
+}
 
 Optimizer::Optimizer(const Terrain& terrainRef) : terrain(terrainRef) {}
 
@@ -11,65 +47,927 @@ std::vector<Point> Optimizer::findPath(const Point& start, const Point& goal) {
 }
 
 std::vector<Point> Optimizer::findPathAStar(const Point& start, const Point& goal) {
-    std::priority_queue<PathNode*, std::vector<PathNode*>, PathNodeComparator> openSet;
-    std::unordered_map<Point, PathNode*, PointHash> allNodes;
-    std::unordered_map<Point, double, PointHash> gScore;
+    if (!terrain.isValidPosition(start) || !terrain.isValidPosition(goal)) {
+        return std::vector<Point>();
+    }
+    
+    SearchWorkspace& ws = workspace;
+    ws.prepare(terrain.cellCount());
+    
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const uint32_t goalCell = static_cast<uint32_t>(terrain.cellIndex(goal.x, goal.y));
     
     // Initialize start node
-    PathNode* startNode = new PathNode(start, 0, terrain.getHeuristicCost(start, goal));
-    openSet.push(startNode);
-    allNodes[start] = startNode;
-    gScore[start] = 0;
+    uint32_t startCell = static_cast<uint32_t>(terrain.cellIndex(start.x, start.y));
+    double startH = terrain.getHeuristicCost(start, goal);
+    ws.visit(startCell, 0.0, SearchWorkspace::NO_PARENT);
+    ws.push(OpenEntry{startH, startH, start.x, start.y});
     
-    std::vector<PathNode*> createdNodes; // For cleanup
-    createdNodes.push_back(startNode);
+    while (!ws.openList.empty()) {
+        OpenEntry current = ws.pop();
+        uint32_t cell = static_cast<uint32_t>(terrain.cellIndex(current.x, current.y));
+        
+        // Check if we reached the goal
+        if (cell == goalCell) {
+            return reconstructPath(ws, cell);
+        }
+        
+        // Skip entries superseded by a cheaper path to the same cell
+        double g = ws.gScore[cell];
+        if (current.fCost > g + current.hCost) continue;
+        
+        // Explore the 8 neighbours, in the same order as Terrain::getNeighbors
+        for (int d = 0; d < 8; d++) {
+            int nx = current.x + NEIGHBOR_DX[d];
+            int ny = current.y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            
+            size_t next = terrain.cellIndex(nx, ny);
+            if (terrain.cellType(next) == TerrainType::OBSTACLE) continue;
+            
+            double tentativeGScore = g + terrain.cellCost(next) * NEIGHBOR_DISTANCE[d];
+            
+            // Check if this path to neighbor is better
+            if (!ws.seen(next) || tentativeGScore < ws.gScore[next]) {
+                ws.visit(next, tentativeGScore, cell);
+                double hCost = terrain.getHeuristicCost(Point(nx, ny), goal);
+                ws.push(OpenEntry{tentativeGScore + hCost, hCost, nx, ny});
+            }
+        }
+    }
+    
+    return std::vector<Point>(); // Empty path = no solution
+}
+
+std::vector<Point> Optimizer::findWindOptimalPath(const Point& start, const Point& goal) {
+    if (!terrain.hasWindField()) {
+        return findPathAStar(start, goal);
+    }
+    if (!terrain.isValidPosition(start) || !terrain.isValidPosition(goal)) {
+        return std::vector<Point>();
+    }
+    
+    SearchWorkspace& ws = workspace;
+    ws.prepare(terrain.cellCount());
+    
+    const uint32_t goalCell = static_cast<uint32_t>(terrain.cellIndex(goal.x, goal.y));
+    const double rate = terrain.getMinEdgeRate(); // Admissible cost per unit distance
+    auto heuristic = [&goal, rate](int x, int y) {
+        double dx = goal.x - x;
+        double dy = goal.y - y;
+        return std::sqrt(dx * dx + dy * dy) * rate;
+    };
+    
+    uint32_t startCell = static_cast<uint32_t>(terrain.cellIndex(start.x, start.y));
+    double startH = heuristic(start.x, start.y);
+    ws.visit(startCell, 0.0, SearchWorkspace::NO_PARENT);
+    ws.push(OpenEntry{startH, startH, start.x, start.y});
+    
+    while (!ws.openList.empty()) {
+        OpenEntry current = ws.pop();
+        uint32_t cell = static_cast<uint32_t>(terrain.cellIndex(current.x, current.y));
+        
+        if (cell == goalCell) {
+            return reconstructPath(ws, cell);
+        }
+        
+        double g = ws.gScore[cell];
+        if (current.fCost > g + current.hCost) continue;
+        
+        // All eight move costs in one aligned load; blocked moves are infinite,
+        // so no bounds or obstacle checks are needed here
+        const DirectionalCosts costs = terrain.edgeCostsAt(cell);
+        for (int d = 0; d < Terrain::DIRECTION_COUNT; d++) {
+            if (!(costs.cost[d] < std::numeric_limits<float>::infinity())) continue;
+            
+            int nx = current.x + NEIGHBOR_DX[d];
+            int ny = current.y + NEIGHBOR_DY[d];
+            size_t next = terrain.cellIndex(nx, ny);
+            double tentativeGScore = g + costs.cost[d];
+            
+            if (!ws.seen(next) || tentativeGScore < ws.gScore[next]) {
+                ws.visit(next, tentativeGScore, cell);
+                double hCost = heuristic(nx, ny);
+                ws.push(OpenEntry{tentativeGScore + hCost, hCost, nx, ny});
+            }
+        }
+    }
+    
+    return std::vector<Point>(); // Empty path = no solution
+}
+
+std::vector<Point> Optimizer::findClearancePath(const Point& start, const Point& goal,
+                                                ClearanceField& clearance, const ClearanceOptions& options) {
+    if (&clearance.getTerrain() != &terrain) {
+        throw std::runtime_error("Clearance field belongs to a different terrain");
+    }
+    if (!terrain.isValidPosition(start) || !terrain.isValidPosition(goal)) {
+        return std::vector<Point>();
+    }
+    clearance.refresh();
+    
+    SearchWorkspace& ws = workspace;
+    ws.prepare(terrain.cellCount());
+    
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const uint32_t goalCell = static_cast<uint32_t>(terrain.cellIndex(goal.x, goal.y));
+    const float minClearance = static_cast<float>(options.minClearance);
+    const bool penalized = options.penaltyWeight > 0.0 && options.penaltyRadius > 0.0;
+    
+    // Penalties only add cost, so the plain heuristic stays admissible
+    uint32_t startCell = static_cast<uint32_t>(terrain.cellIndex(start.x, start.y));
+    double startH = terrain.getHeuristicCost(start, goal);
+    ws.visit(startCell, 0.0, SearchWorkspace::NO_PARENT);
+    ws.push(OpenEntry{startH, startH, start.x, start.y});
+    
+    while (!ws.openList.empty()) {
+        OpenEntry current = ws.pop();
+        uint32_t cell = static_cast<uint32_t>(terrain.cellIndex(current.x, current.y));
+        
+        if (cell == goalCell) {
+            return reconstructPath(ws, cell);
+        }
+        
+        double g = ws.gScore[cell];
+        if (current.fCost > g + current.hCost) continue;
+        
+        for (int d = 0; d < 8; d++) {
+            int nx = current.x + NEIGHBOR_DX[d];
+            int ny = current.y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            
+            size_t next = terrain.cellIndex(nx, ny);
+            if (terrain.cellType(next) == TerrainType::OBSTACLE) continue;
+            
+            float room = clearance.clearanceAt(next);
+            if (room < minClearance) continue;
+            
+            double rate = terrain.cellCost(next);
+            if (penalized && room < options.penaltyRadius) {
+                rate += options.penaltyWeight * (options.penaltyRadius - room);
+            }
+            double tentativeGScore = g + rate * NEIGHBOR_DISTANCE[d];
+            
+            if (!ws.seen(next) || tentativeGScore < ws.gScore[next]) {
+                ws.visit(next, tentativeGScore, cell);
+                double hCost = terrain.getHeuristicCost(Point(nx, ny), goal);
+                ws.push(OpenEntry{tentativeGScore + hCost, hCost, nx, ny});
+            }
+        }
+    }
+    
+    return std::vector<Point>(); // Empty path = no solution
+}
+
+std::vector<FlightPoint> Optimizer::findFlightPath(const Point& start, const Point& goal, const FlightLevels& levels) {
+    if (&levels.getTerrain() != &terrain) {
+        throw std::runtime_error("Flight levels belong to a different terrain");
+    }
+    if (!terrain.isValidPosition(start) || !terrain.isValidPosition(goal)) {
+        return std::vector<FlightPoint>();
+    }
+    
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const int levelCount = levels.levelCount();
+    const FlightLevelSettings& settings = levels.getSettings();
+    const int startLevel = levels.getFloor(start.x, start.y);
+    const int goalLevel = levels.getFloor(goal.x, goal.y);
+    if (startLevel >= levelCount || goalLevel >= levelCount) {
+        return std::vector<FlightPoint>();
+    }
+    
+    // States are allocated per visited column, one for each level of its
+    // free run [floor, levelCount): the workspace parent of a cell holds
+    // the index of its column, so memory follows the airspace the search
+    // reaches, not the map or the blocked levels below the floors
+    struct FlightColumn {
+        int x, y;
+        int floor;
+        uint32_t firstState; // State of the floor level
+    };
+    struct FlightState {
+        double gScore;
+        uint32_t parent;
+        uint32_t column;
+    };
+    struct FlightEntry {
+        double fCost;
+        double hCost;
+        uint32_t state;
+        bool operator<(const FlightEntry& other) const {
+            if (fCost != other.fCost) return fCost > other.fCost;
+            return hCost > other.hCost;
+        }
+    };
+    SearchWorkspace& ws = workspace;
+    ws.prepare(terrain.cellCount());
+    std::vector<FlightColumn> columns;
+    std::vector<FlightState> states;
+    std::priority_queue<FlightEntry> openSet;
+    
+    // Horizontal distance at the cheapest air rate, plus the vertical
+    // distance to the landing level at its per-level cost
+    const double rate = levels.getMinAirRate();
+    auto heuristic = [&](int x, int y, int level) {
+        double dx = goal.x - x;
+        double dy = goal.y - y;
+        double vertical = level < goalLevel ? (goalLevel - level) * settings.climbCost
+                                            : (level - goalLevel) * settings.descendCost;
+        return std::sqrt(dx * dx + dy * dy) * rate + vertical;
+    };
+    auto relax = [&](int x, int y, int level, double g, uint32_t from) {
+        size_t cell = terrain.cellIndex(x, y);
+        if (!ws.seen(cell)) {
+            uint32_t column = static_cast<uint32_t>(columns.size());
+            int floor = levels.floorAt(cell);
+            ws.visit(cell, 0.0, column);
+            columns.push_back(FlightColumn{x, y, floor, static_cast<uint32_t>(states.size())});
+            states.resize(states.size() + (levelCount - floor),
+                          FlightState{std::numeric_limits<double>::infinity(), SearchWorkspace::NO_PARENT, column});
+        }
+        const FlightColumn& column = columns[ws.parent[cell]];
+        uint32_t id = column.firstState + (level - column.floor);
+        if (!(g < states[id].gScore)) return;
+        states[id].gScore = g;
+        states[id].parent = from;
+        double h = heuristic(x, y, level);
+        openSet.push(FlightEntry{g + h, h, id});
+    };
+    auto stateAt = [&](uint32_t id) {
+        const FlightColumn& column = columns[states[id].column];
+        return FlightPoint(column.x, column.y, column.floor + static_cast<int>(id - column.firstState));
+    };
+    
+    relax(start.x, start.y, startLevel, 0.0, SearchWorkspace::NO_PARENT);
     
     while (!openSet.empty()) {
-        PathNode* current = openSet.top();
+        FlightEntry current = openSet.top();
         openSet.pop();
+        uint32_t id = current.state;
+        double g = states[id].gScore;
+        if (current.fCost > g + current.hCost) continue;
         
-        // Check if we reached the goal
-        if (current->position == goal) {
-            std::vector<Point> path = reconstructPath(current);
-            
-            // Cleanup
-            for (PathNode* node : createdNodes) {
-                delete node;
+        const FlightPoint here = stateAt(id);
+        if (here.x == goal.x && here.y == goal.y && here.level == goalLevel) {
+            std::vector<FlightPoint> route;
+            for (uint32_t at = id; at != SearchWorkspace::NO_PARENT; at = states[at].parent) {
+                route.push_back(stateAt(at));
             }
+            std::reverse(route.begin(), route.end());
+            return route;
+        }
+        
+        for (int d = 0; d < 8; d++) {
+            int nx = here.x + NEIGHBOR_DX[d];
+            int ny = here.y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            if (levels.getFloor(nx, ny) > here.level) continue;
+            relax(nx, ny, here.level, g + levels.airRate(nx, ny) * NEIGHBOR_DISTANCE[d], id);
+        }
+        if (here.level + 1 < levelCount) {
+            relax(here.x, here.y, here.level + 1, g + settings.climbCost, id);
+        }
+        if (here.level > levels.getFloor(here.x, here.y)) {
+            relax(here.x, here.y, here.level - 1, g + settings.descendCost, id);
+        }
+    }
+    
+    return std::vector<FlightPoint>(); // Empty path = no solution
+}
+
+void Optimizer::backwardEnergySearch(const Point& start, const Point& goal, double budget,
+                                     const std::vector<uint8_t>* penalised, double penalty) {
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const size_t startCell = terrain.cellIndex(start.x, start.y);
+    const uint32_t goalCell = static_cast<uint32_t>(terrain.cellIndex(goal.x, goal.y));
+    if (labelHead.size() < terrain.cellCount()) {
+        labelHead.resize(terrain.cellCount());
+        settledEnergy.resize(terrain.cellCount());
+    }
+    
+    SearchWorkspace& ws = workspace;
+    ws.prepare(terrain.cellCount());
+    ws.visit(goalCell, 0.0, SearchWorkspace::NO_PARENT);
+    labelHead[goalCell] = SearchWorkspace::NO_PARENT;
+    settledEnergy[goalCell] = std::numeric_limits<double>::infinity();
+    ws.push(OpenEntry{0.0, 0.0, goal.x, goal.y});
+    
+    while (!ws.openList.empty() && !energyBelow(budget, ws.openList.front().fCost)) {
+        OpenEntry current = ws.pop();
+        uint32_t cell = static_cast<uint32_t>(terrain.cellIndex(current.x, current.y));
+        double g = ws.gScore[cell];
+        if (current.fCost > g) continue;
+        if (terrain.cellType(cell) == TerrainType::OBSTACLE) continue; // Only an obstacle goal gets here
+        
+        // Every move into this cell costs the same per unit distance
+        double rate = terrain.cellCost(cell);
+        if (penalised && (*penalised)[cell] && cell != goalCell) {
+            if (!(penalty < std::numeric_limits<double>::infinity())) continue; // Cannot be entered
+            rate *= penalty;
+        }
+        for (int d = 0; d < 8; d++) {
+            int nx = current.x + NEIGHBOR_DX[d];
+            int ny = current.y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            
+            size_t from = terrain.cellIndex(nx, ny);
+            if (terrain.cellType(from) == TerrainType::OBSTACLE && from != startCell) continue;
             
+            double tentative = g + rate * NEIGHBOR_DISTANCE[d];
+            if (!ws.seen(from)) {
+                labelHead[from] = SearchWorkspace::NO_PARENT;
+                settledEnergy[from] = std::numeric_limits<double>::infinity();
+            } else if (tentative >= ws.gScore[from]) {
+                continue;
+            }
+            ws.visit(from, tentative, cell);
+            ws.push(OpenEntry{tentative, 0.0, nx, ny});
+        }
+    }
+}
+
+std::vector<Point> Optimizer::findEnergyConstrainedPath(const Point& start, const Point& goal, const Drone& drone) {
+    return findEnergyConstrainedPath(start, goal, drone.getUsableEnergy());
+}
+
+std::vector<Point> Optimizer::findEnergyConstrainedPath(const Point& start, const Point& goal, double energyBudget) {
+    if (!terrain.isValidPosition(start) || !terrain.isValidPosition(goal) || !(energyBudget >= 0.0)) {
+        return std::vector<Point>();
+    }
+    
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const double unreachable = std::numeric_limits<double>::infinity();
+    const uint32_t startCell = static_cast<uint32_t>(terrain.cellIndex(start.x, start.y));
+    
+    // Least energy from each cell to the goal. Cells settled beyond the
+    // budget can never finish in time, so the search stops there
+    backwardEnergySearch(start, goal, energyBudget);
+    SearchWorkspace& ws = workspace;
+    auto energyToGoal = [&](size_t cell) { return ws.seen(cell) ? ws.gScore[cell] : unreachable; };
+    if (energyBelow(energyBudget, energyToGoal(startCell))) {
+        return std::vector<Point>(); // Even the least-energy route is over budget
+    }
+    
+    // The least-energy route fits, so it bounds the answer: walk it back
+    // from the start and only look for strictly shorter routes
+    std::vector<Point> leastEnergy;
+    double upperBound = 0.0;
+    for (uint32_t cell = startCell; cell != SearchWorkspace::NO_PARENT; cell = ws.parent[cell]) {
+        Point p = terrain.cellPoint(cell);
+        if (!leastEnergy.empty()) upperBound += calculateDistance(leastEnergy.back(), p);
+        leastEnergy.push_back(p);
+    }
+    
+    // Forward label-setting search on distance. Labels are popped in order
+    // of distance plus the octile distance to the goal, so the first goal
+    // label popped is the shortest route within the budget, and labels of
+    // a cell are popped by increasing distance: a newcomer is dominated
+    // unless it needs less energy than the last label popped there, and
+    // the cell's list only has to hold labels still in the queue.
+    struct LabelEntry {
+        double fCost;
+        double hCost;
+        uint32_t label;
+        bool operator<(const LabelEntry& other) const {
+            if (fCost != other.fCost) return fCost > other.fCost;
+            return hCost > other.hCost;
+        }
+    };
+    std::priority_queue<LabelEntry> openSet;
+    labelPool.clear();
+    
+    auto heuristic = [&goal](int x, int y) {
+        int dx = std::abs(goal.x - x);
+        int dy = std::abs(goal.y - y);
+        return (NEIGHBOR_DISTANCE[0] - 1.0) * std::min(dx, dy) + std::max(dx, dy);
+    };
+    auto addLabel = [&](int x, int y, size_t cell, double distance, double energy, uint32_t from) {
+        double h = heuristic(x, y);
+        if (distance + h >= upperBound || energy >= settledEnergy[cell] ||
+            energyBelow(energyBudget, energy + energyToGoal(cell))) return;
+        
+        // Keep the cell's open labels Pareto-optimal: reject the newcomer if
+        // any dominates it, otherwise drop the ones it dominates
+        uint32_t* link = &labelHead[cell];
+        while (*link != SearchWorkspace::NO_PARENT) {
+            EnergyLabel& other = labelPool[*link];
+            if (other.distance <= distance && other.energy <= energy) return;
+            if (distance <= other.distance && energy <= other.energy) {
+                other.active = false;
+                *link = other.next;
+            } else {
+                link = &other.next;
+            }
+        }
+        
+        if (labelPool.size() >= SearchWorkspace::NO_PARENT) {
+            throw std::runtime_error("Too many labels for the energy-constrained search");
+        }
+        uint32_t id = static_cast<uint32_t>(labelPool.size());
+        labelPool.push_back(EnergyLabel{distance, energy, from, labelHead[cell], x, y, true});
+        labelHead[cell] = id;
+        openSet.push(LabelEntry{distance + h, h, id});
+    };
+    
+    addLabel(start.x, start.y, startCell, 0.0, 0.0, SearchWorkspace::NO_PARENT);
+    
+    while (!openSet.empty()) {
+        uint32_t id = openSet.top().label;
+        openSet.pop();
+        const EnergyLabel current = labelPool[id];
+        if (!current.active) continue;
+        
+        // Settle the label: it leaves the open list of its cell
+        size_t here = terrain.cellIndex(current.x, current.y);
+        settledEnergy[here] = current.energy;
+        for (uint32_t* link = &labelHead[here]; *link != SearchWorkspace::NO_PARENT; link = &labelPool[*link].next) {
+            if (*link == id) {
+                *link = current.next;
+                break;
+            }
+        }
+        
+        if (current.x == goal.x && current.y == goal.y) {
+            std::vector<Point> path;
+            for (uint32_t at = id; at != SearchWorkspace::NO_PARENT; at = labelPool[at].parent) {
+                path.push_back(Point(labelPool[at].x, labelPool[at].y));
+            }
+            std::reverse(path.begin(), path.end());
             return path;
         }
         
-        // Explore neighbors
-        std::vector<Point> neighbors = terrain.getNeighbors(current->position);
+        for (int d = 0; d < 8; d++) {
+            int nx = current.x + NEIGHBOR_DX[d];
+            int ny = current.y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            
+            size_t next = terrain.cellIndex(nx, ny);
+            if (terrain.cellType(next) == TerrainType::OBSTACLE) continue;
+            addLabel(nx, ny, next, current.distance + NEIGHBOR_DISTANCE[d],
+                     current.energy + terrain.cellCost(next) * NEIGHBOR_DISTANCE[d], id);
+        }
+    }
+    
+    return leastEnergy; // Nothing shorter fits the budget
+}
+
+std::vector<ParetoPath> Optimizer::findParetoPaths(const Point& start, const Point& goal, size_t maxFrontSize) {
+    std::vector<ParetoPath> front;
+    if (!terrain.isValidPosition(start) || !terrain.isValidPosition(goal)) {
+        return front;
+    }
+    
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const double unreachable = std::numeric_limits<double>::infinity();
+    const double sqrt2 = NEIGHBOR_DISTANCE[0];
+    const size_t startCell = terrain.cellIndex(start.x, start.y);
+    
+    // Exact least energy to the goal from every cell that can reach it
+    backwardEnergySearch(start, goal, unreachable);
+    SearchWorkspace& ws = workspace;
+    if (!ws.seen(startCell)) {
+        return front;
+    }
+    const double leastEnergy = ws.gScore[startCell];
+    
+    // Distances are kept exactly as straight + diagonal * sqrt(2) step
+    // counts, so routes of equal length compare equal however they were
+    // summed. Entries hold f-values: the label's counts plus the octile
+    // distance to the goal, which has the same form.
+    struct LabelEntry {
+        double fDistance; // fStraight + fDiagonal * sqrt(2), for the common case
+        double fEnergy;
+        int32_t fStraight;
+        int32_t fDiagonal;
+        uint32_t label;
+        bool operator<(const LabelEntry& other) const {
+            // Far apart in floating point means far apart exactly
+            if (std::fabs(fDistance - other.fDistance) > 1e-6) return fDistance > other.fDistance;
+            
+            // Sign of (a + b * sqrt(2)), decided in integers
+            int64_t a = static_cast<int64_t>(fStraight) - other.fStraight;
+            int64_t b = static_cast<int64_t>(fDiagonal) - other.fDiagonal;
+            if (a == 0 && b == 0) return fEnergy > other.fEnergy;
+            if (a >= 0 && b >= 0) return true;
+            if (a <= 0 && b <= 0) return false;
+            return a > 0 ? a * a > 2 * b * b : 2 * b * b > a * a;
+        }
+    };
+    std::priority_queue<LabelEntry> openSet;
+    labelPool.clear();
+    
+    auto octile = [&goal](int x, int y, int32_t& straight, int32_t& diagonal) {
+        int dx = std::abs(goal.x - x);
+        int dy = std::abs(goal.y - y);
+        diagonal = std::min(dx, dy);
+        straight = std::max(dx, dy) - diagonal;
+    };
+    
+    // A label can still end on the front if its energy bound beats the
+    // last route by the cap's step, or it can still reach the least
+    // energy (see energyBelow).
+    double lastEnergy = unreachable;
+    double step = 0.0;
+    auto promising = [&](double fEnergy) {
+        return energyBelow(fEnergy, lastEnergy) &&
+               (energyBelow(fEnergy, lastEnergy - step) || !energyBelow(leastEnergy, fEnergy));
+    };
+    auto addLabel = [&](int x, int y, size_t cell, int32_t straight, int32_t diagonal, double energy, uint32_t from) {
+        if (!energyBelow(energy, settledEnergy[cell])) return;
+        double fEnergy = energy + ws.gScore[cell];
+        if (!promising(fEnergy)) return;
         
-        for (const Point& neighbor : neighbors) {
-            double movementCost = terrain.getMovementCost(neighbor);
+        if (labelPool.size() >= SearchWorkspace::NO_PARENT) {
+            throw std::runtime_error("Too many labels for the Pareto search");
+        }
+        uint32_t id = static_cast<uint32_t>(labelPool.size());
+        labelPool.push_back(EnergyLabel{straight + diagonal * sqrt2, energy, from, SearchWorkspace::NO_PARENT, x, y, true});
+        int32_t hStraight, hDiagonal;
+        octile(x, y, hStraight, hDiagonal);
+        int32_t fStraight = straight + hStraight;
+        int32_t fDiagonal = diagonal + hDiagonal;
+        openSet.push(LabelEntry{fStraight + fDiagonal * sqrt2, fEnergy, fStraight, fDiagonal, id});
+    };
+    
+    addLabel(start.x, start.y, startCell, 0, 0, 0.0, SearchWorkspace::NO_PARENT);
+    
+    while (!openSet.empty()) {
+        LabelEntry entry = openSet.top();
+        openSet.pop();
+        const EnergyLabel current = labelPool[entry.label];
+        size_t here = terrain.cellIndex(current.x, current.y);
+        
+        // Bounds may have tightened since the label was queued
+        if (!energyBelow(current.energy, settledEnergy[here]) || !promising(entry.fEnergy)) continue;
+        settledEnergy[here] = current.energy;
+        
+        if (current.x == goal.x && current.y == goal.y) {
+            ParetoPath route;
+            for (uint32_t at = entry.label; at != SearchWorkspace::NO_PARENT; at = labelPool[at].parent) {
+                route.path.push_back(Point(labelPool[at].x, labelPool[at].y));
+            }
+            std::reverse(route.path.begin(), route.path.end());
+            route.distance = current.distance;
+            route.energy = current.energy;
+            front.push_back(std::move(route));
             
-            // Skip if obstacle
-            if (movementCost >= 1000.0) continue;
+            lastEnergy = current.energy;
+            // A cap of one keeps just the shortest route; larger caps have
+            // step * (maxFrontSize - 1) cover the range, so the last route
+            // allowed is the least-energy one
+            if (maxFrontSize != 0 && front.size() >= maxFrontSize) break;
+            if (maxFrontSize != 0 && front.size() == 1) {
+                step = maxFrontSize > 1 ? (lastEnergy - leastEnergy) / (maxFrontSize - 1) : unreachable;
+            }
+            continue;
+        }
+        
+        // At the goal the octile distance is zero, so f holds the counts
+        int32_t hStraight, hDiagonal;
+        octile(current.x, current.y, hStraight, hDiagonal);
+        int32_t straight = entry.fStraight - hStraight;
+        int32_t diagonal = entry.fDiagonal - hDiagonal;
+        for (int d = 0; d < 8; d++) {
+            int nx = current.x + NEIGHBOR_DX[d];
+            int ny = current.y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
             
-            // Calculate diagonal movement cost
-            double distance = calculateDistance(current->position, neighbor);
-            double tentativeGScore = current->gCost + movementCost * distance;
+            size_t next = terrain.cellIndex(nx, ny);
+            if (terrain.cellType(next) == TerrainType::OBSTACLE || !ws.seen(next)) continue;
+            bool diagonalMove = NEIGHBOR_DX[d] != 0 && NEIGHBOR_DY[d] != 0;
+            addLabel(nx, ny, next, straight + !diagonalMove, diagonal + diagonalMove,
+                     current.energy + terrain.cellCost(next) * NEIGHBOR_DISTANCE[d], entry.label);
+        }
+    }
+    
+    return front;
+}
+
+std::vector<std::vector<Point>> Optimizer::findKPaths(const Point& start, const Point& goal, size_t k,
+                                                      double diversity, unsigned threadCount) {
+    if (!(diversity >= 0.0 && diversity <= 1.0)) {
+        throw std::runtime_error("Route diversity must be between 0 and 1");
+    }
+    std::vector<std::vector<Point>> routes;
+    if (k == 0 || !terrain.isValidPosition(start) || !terrain.isValidPosition(goal)) {
+        return routes;
+    }
+    
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const size_t cells = terrain.cellCount();
+    const double unreachable = std::numeric_limits<double>::infinity();
+    const double penalty = diversity < 1.0 ? 1.0 / (1.0 - diversity) : unreachable;
+    const uint32_t startCell = static_cast<uint32_t>(terrain.cellIndex(start.x, start.y));
+    const uint32_t goalCell = static_cast<uint32_t>(terrain.cellIndex(goal.x, goal.y));
+    
+    // Exact least energy from every cell to the goal. Blocking cells only
+    // makes routes dearer, so it stays a consistent heuristic for every
+    // spur search. Penalties change the costs themselves, so the search is
+    // redone with them for each accepted route when diversity is above 0.
+    backwardEnergySearch(start, goal, unreachable);
+    const SearchWorkspace& toGoal = workspace;
+    if (!toGoal.seen(startCell)) {
+        return routes;
+    }
+    
+    auto stepLength = [&](uint32_t from, uint32_t to) {
+        return calculateDistance(terrain.cellPoint(from), terrain.cellPoint(to));
+    };
+    auto routeEnergy = [&](const std::vector<uint32_t>& route) {
+        double energy = 0.0;
+        for (size_t i = 1; i < route.size(); i++) {
+            energy += terrain.cellCost(route[i]) * stepLength(route[i - 1], route[i]);
+        }
+        return energy;
+    };
+    auto edgeKey = [](uint32_t a, uint32_t b) {
+        return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+    };
+    
+    // Candidates wait in a heap by energy. Every route ever queued is
+    // remembered, so no spur search can queue the same one twice.
+    struct Candidate {
+        std::vector<uint32_t> cells;
+        double energy;
+        size_t deviation; // First spur cell; the root before it came from the parent route
+    };
+    std::vector<Candidate> candidates;
+    typedef std::pair<double, size_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> openSet;
+    std::set<std::vector<uint32_t>> queued;
+    auto addCandidate = [&](std::vector<uint32_t>&& cellsOfRoute, size_t deviation) {
+        if (!queued.insert(cellsOfRoute).second) return;
+        double energy = routeEnergy(cellsOfRoute);
+        candidates.push_back(Candidate{std::move(cellsOfRoute), energy, deviation});
+        openSet.push(Entry(energy, candidates.size() - 1));
+    };
+    
+    // The least-energy route falls out of the backward search
+    std::vector<uint32_t> cheapest;
+    for (uint32_t cell = startCell; cell != SearchWorkspace::NO_PARENT; cell = toGoal.parent[cell]) {
+        cheapest.push_back(cell);
+    }
+    addCandidate(std::move(cheapest), 0);
+    
+    std::vector<size_t> taken;                      // Candidates popped so far, accepted or not
+    std::vector<size_t> accepted;
+    std::vector<std::vector<uint64_t>> acceptedEdges; // Sorted edgeKeys of each accepted route
+    std::vector<uint8_t> used(cells, 0);             // Cells of accepted routes, penalised in spur searches
+    std::vector<uint32_t> position(cells, SearchWorkspace::NO_PARENT); // Index of each cell in the route being spurred
+    std::vector<uint32_t> ahead(cells);             // See below, per route being spurred
+    std::vector<uint32_t> aheadRound(cells, 0);     // accepted.size() when ahead was filled in
+    std::vector<uint32_t> pending;
+    std::vector<size_t> common;                     // Per taken route, length of its prefix shared with the route being spurred
+    std::vector<std::vector<uint32_t>> spurs;
+    
+    // Enough of the route's length must be off each accepted route
+    auto diverseEnough = [&](const std::vector<uint32_t>& route) {
+        double length = 0.0;
+        for (size_t i = 1; i < route.size(); i++) length += stepLength(route[i - 1], route[i]);
+        for (const std::vector<uint64_t>& edges : acceptedEdges) {
+            double shared = 0.0;
+            for (size_t i = 1; i < route.size(); i++) {
+                if (std::binary_search(edges.begin(), edges.end(), edgeKey(route[i - 1], route[i]))) {
+                    shared += stepLength(route[i - 1], route[i]);
+                }
+            }
+            if (shared > (1.0 - diversity) * length + 1e-9) return false;
+        }
+        return true;
+    };
+    
+    // For each cell, the lowest position in the route being spurred along
+    // its least-energy path to the goal, not counting the cell itself.
+    // Filled in for every cell the backward search reached, each cell from
+    // its already filled parent.
+    auto fillAhead = [&]() {
+        const uint32_t round = static_cast<uint32_t>(accepted.size());
+        ahead[goalCell] = SearchWorkspace::NO_PARENT;
+        aheadRound[goalCell] = round;
+        for (uint32_t cell = 0; cell < cells; cell++) {
+            if (!toGoal.seen(cell) || aheadRound[cell] == round) continue;
+            pending.clear();
+            for (uint32_t at = cell; aheadRound[at] != round; at = toGoal.parent[at]) pending.push_back(at);
+            for (size_t i = pending.size(); i-- > 0;) {
+                uint32_t next = toGoal.parent[pending[i]];
+                ahead[pending[i]] = std::min(ahead[next], position[next]);
+                aheadRound[pending[i]] = round;
+            }
+        }
+    };
+    
+    // A* from route[spur] to the goal. Cells before the spur are blocked,
+    // which keeps the route loopless, and so is the next move of every
+    // taken route that shares the root, so the result is a new route. Once
+    // the popped cell's least-energy path to the goal avoids every blocked
+    // cell, its heuristic is exact and that path ends the search, so spurs
+    // that rejoin the route quickly stay cheap.
+    auto spurSearch = [&](SearchWorkspace& ws, const std::vector<uint32_t>& route, size_t spur,
+                          std::vector<uint32_t>& spurPath) {
+        spurPath.clear();
+        std::vector<uint32_t> blockedMoves;
+        for (size_t t = 0; t < taken.size(); t++) {
+            const std::vector<uint32_t>& other = candidates[taken[t]].cells;
+            if (common[t] > spur && other.size() > spur + 1) blockedMoves.push_back(other[spur + 1]);
+        }
+        
+        const uint32_t origin = route[spur];
+        Point from = terrain.cellPoint(origin);
+        ws.prepare(cells);
+        ws.visit(origin, 0.0, SearchWorkspace::NO_PARENT);
+        ws.push(OpenEntry{toGoal.gScore[origin], toGoal.gScore[origin], from.x, from.y});
+        
+        while (!ws.openList.empty()) {
+            OpenEntry current = ws.pop();
+            uint32_t cell = static_cast<uint32_t>(terrain.cellIndex(current.x, current.y));
+            double g = ws.gScore[cell];
+            if (current.fCost > g + current.hCost) continue;
             
-            // Check if this path to neighbor is better
-            if (gScore.find(neighbor) == gScore.end() || tentativeGScore < gScore[neighbor]) {
-                gScore[neighbor] = tentativeGScore;
+            if (cell != origin && ahead[cell] > spur) {
+                for (uint32_t at = cell; at != SearchWorkspace::NO_PARENT; at = ws.parent[at]) {
+                    spurPath.push_back(at);
+                }
+                std::reverse(spurPath.begin(), spurPath.end());
+                for (uint32_t at = toGoal.parent[cell]; at != SearchWorkspace::NO_PARENT; at = toGoal.parent[at]) {
+                    spurPath.push_back(at);
+                }
+                return;
+            }
+            
+            for (int d = 0; d < 8; d++) {
+                int nx = current.x + NEIGHBOR_DX[d];
+                int ny = current.y + NEIGHBOR_DY[d];
+                if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
                 
-                double hCost = terrain.getHeuristicCost(neighbor, goal);
-                PathNode* neighborNode = new PathNode(neighbor, tentativeGScore, hCost, current);
+                uint32_t next = static_cast<uint32_t>(terrain.cellIndex(nx, ny));
+                if (terrain.cellType(next) == TerrainType::OBSTACLE || !toGoal.seen(next)) continue;
+                if (position[next] < spur) continue;
+                if (cell == origin &&
+                    std::find(blockedMoves.begin(), blockedMoves.end(), next) != blockedMoves.end()) continue;
                 
-                allNodes[neighbor] = neighborNode;
-                openSet.push(neighborNode);
-                createdNodes.push_back(neighborNode);
+                double rate = terrain.cellCost(next);
+                if (used[next] && next != goalCell) {
+                    if (!(penalty < unreachable)) continue;
+                    rate *= penalty;
+                }
+                double tentativeGScore = g + rate * NEIGHBOR_DISTANCE[d];
+                if (!ws.seen(next) || tentativeGScore < ws.gScore[next]) {
+                    ws.visit(next, tentativeGScore, cell);
+                    double hCost = toGoal.gScore[next];
+                    ws.push(OpenEntry{tentativeGScore + hCost, hCost, nx, ny});
+                }
+            }
+        }
+    };
+    
+    while (!openSet.empty() && accepted.size() < k) {
+        size_t id = openSet.top().second;
+        openSet.pop();
+        taken.push_back(id);
+        const std::vector<uint32_t> route = candidates[id].cells; // New candidates may move the storage
+        if (!diverseEnough(route)) continue;
+        
+        accepted.push_back(id);
+        std::vector<uint64_t> edges;
+        for (size_t i = 1; i < route.size(); i++) edges.push_back(edgeKey(route[i - 1], route[i]));
+        std::sort(edges.begin(), edges.end());
+        acceptedEdges.push_back(std::move(edges));
+        for (uint32_t cell : route) used[cell] = 1;
+        if (accepted.size() == k) break;
+        
+        // Spur from every cell at or after the deviation: earlier ones were
+        // already covered by the parent route's spurs
+        common.clear();
+        for (size_t t : taken) {
+            const std::vector<uint32_t>& other = candidates[t].cells;
+            size_t shared = 0;
+            while (shared < other.size() && shared < route.size() && other[shared] == route[shared]) shared++;
+            common.push_back(shared);
+        }
+        if (penalty != 1.0) {
+            backwardEnergySearch(start, goal, unreachable, &used, penalty);
+        }
+        for (size_t i = 0; i < route.size(); i++) position[route[i]] = static_cast<uint32_t>(i);
+        fillAhead();
+        
+        const size_t first = candidates[id].deviation;
+        const size_t count = route.size() > first + 1 ? route.size() - 1 - first : 0;
+        unsigned workers = threadCount != 0 ? threadCount : defaultThreadCount();
+        if (spurWorkspaces.size() < workers) spurWorkspaces.resize(workers);
+        spurs.resize(count);
+        parallelFor(0, count, workers, [&](size_t begin, size_t end, unsigned chunk) {
+            for (size_t i = begin; i < end; i++) {
+                spurSearch(spurWorkspaces[chunk], route, first + i, spurs[i]);
             }
+        });
+        
+        for (uint32_t cell : route) position[cell] = SearchWorkspace::NO_PARENT;
+        for (size_t i = 0; i < count; i++) {
+            if (spurs[i].empty()) continue;
+            std::vector<uint32_t> next(route.begin(), route.begin() + first + i);
+            next.insert(next.end(), spurs[i].begin(), spurs[i].end());
+            addCandidate(std::move(next), first + i);
         }
     }
     
-    // Cleanup if no path found
-    for (PathNode* node : createdNodes) {
-        delete node;
+    // Penalised spur searches can find a cheaper route after a dearer one
+    std::stable_sort(accepted.begin(), accepted.end(), [&](size_t a, size_t b) {
+        return candidates[a].energy < candidates[b].energy;
+    });
+    for (size_t id : accepted) {
+        std::vector<Point> path;
+        for (uint32_t cell : candidates[id].cells) path.push_back(terrain.cellPoint(cell));
+        routes.push_back(std::move(path));
+    }
+    return routes;
+}
+
+std::vector<Point> Optimizer::findTimeDependentPath(const Point& start, const Point& goal,
+                                                   const WindForecast& forecast,
+                                                   double departureTime, double airspeed) {
+    if (forecast.getWidth() != terrain.getWidth() || forecast.getHeight() != terrain.getHeight()) {
+        throw std::runtime_error("Wind forecast size does not match the terrain");
+    }
+    if (!(airspeed > 0.0)) {
+        throw std::runtime_error("Airspeed must be positive");
+    }
+    if (!terrain.isValidPosition(start) || !terrain.isValidPosition(goal)) {
+        return std::vector<Point>();
+    }
+    
+    // Frames appended while we search are picked up by the next query
+    WindForecast::Snapshot frames = forecast.snapshot();
+    
+    SearchWorkspace& ws = workspace;
+    ws.prepare(terrain.cellCount());
+    if (arrivalTime.size() < terrain.cellCount()) {
+        arrivalTime.resize(terrain.cellCount());
+    }
+    
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const CostProfile& profile = terrain.getCostProfile();
+    const uint32_t goalCell = static_cast<uint32_t>(terrain.cellIndex(goal.x, goal.y));
+    
+    // No wind can scale a move below minWindScale
+    const double rate = terrain.getMinCellCost() * std::min(1.0, profile.minWindScale);
+    auto heuristic = [&goal, rate](int x, int y) {
+        double dx = goal.x - x;
+        double dy = goal.y - y;
+        return std::sqrt(dx * dx + dy * dy) * rate;
+    };
+    
+    uint32_t startCell = static_cast<uint32_t>(terrain.cellIndex(start.x, start.y));
+    double startH = heuristic(start.x, start.y);
+    ws.visit(startCell, 0.0, SearchWorkspace::NO_PARENT);
+    arrivalTime[startCell] = departureTime;
+    ws.push(OpenEntry{startH, startH, start.x, start.y});
+    
+    while (!ws.openList.empty()) {
+        OpenEntry current = ws.pop();
+        uint32_t cell = static_cast<uint32_t>(terrain.cellIndex(current.x, current.y));
+        
+        if (cell == goalCell) {
+            return reconstructPath(ws, cell);
+        }
+        
+        double g = ws.gScore[cell];
+        if (current.fCost > g + current.hCost) continue;
+        
+        double now = arrivalTime[cell];
+        WindForecast::Blend blend = WindForecast::blendAt(*frames, now);
+        WindVector here = WindForecast::sample(blend, static_cast<size_t>(current.y) * width + current.x);
+        
+        for (int d = 0; d < 8; d++) {
+            int nx = current.x + NEIGHBOR_DX[d];
+            int ny = current.y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            
+            size_t next = terrain.cellIndex(nx, ny);
+            if (terrain.cellType(next) == TerrainType::OBSTACLE) continue;
+            
+            // Same headwind model as Terrain's directional edge costs
+            WindVector there = WindForecast::sample(blend, static_cast<size_t>(ny) * width + nx);
+            double distance = NEIGHBOR_DISTANCE[d];
+            double headwind = -((here.x + there.x) * NEIGHBOR_DX[d] + (here.y + there.y) * NEIGHBOR_DY[d]) /
+                              (2.0 * distance);
+            double tentativeGScore = g + terrain.cellCost(next) * distance * profile.windScale(headwind);
+            
+            if (!ws.seen(next) || tentativeGScore < ws.gScore[next]) {
+                ws.visit(next, tentativeGScore, cell);
+                double groundSpeed = std::max(0.1 * airspeed, airspeed - headwind);
+                arrivalTime[next] = now + distance / groundSpeed;
+                double hCost = heuristic(nx, ny);
+                ws.push(OpenEntry{tentativeGScore + hCost, hCost, nx, ny});
+            }
+        }
     }
     
     return std::vector<Point>(); // Empty path = no solution
@@ -107,7 +1005,6 @@ std::vector<Point> Optimizer::findPathDijkstra(const Point& start, const Point&
         
         for (const Point& neighbor : neighbors) {
             double movementCost = terrain.getMovementCost(neighbor);
-            if (movementCost >= 1000.0) continue;
             
             double distance = calculateDistance(current->position, neighbor);
             double newDistance = current->gCost + movementCost * distance;
@@ -143,6 +1040,16 @@ std::vector<Point> Optimizer::reconstructPath(PathNode* goalNode) {
     return path;
 }
 
+std::vector<Point> Optimizer::reconstructPath(const SearchWorkspace& ws, uint32_t goalCell) const {
+    std::vector<Point> path;
+    for (uint32_t cell = goalCell; cell != SearchWorkspace::NO_PARENT; cell = ws.parent[cell]) {
+        path.push_back(terrain.cellPoint(cell));
+    }
+    
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
 double Optimizer::calculateDistance(const Point& a, const Point& b) const {
     double dx = a.x - b.x;
     double dy = a.y - b.y;
@@ -200,6 +1107,15 @@ double Optimizer::calculatePathCost(const std::vector<Point>& path) const {
     return totalCost;
 }
 
+double Optimizer::calculatePathEnergy(const std::vector<Point>& path) const {
+    double totalEnergy = 0.0;
+    for (size_t i = 1; i < path.size(); i++) {
+        totalEnergy += terrain.getMovementCost(path[i]) * calculateDistance(path[i - 1], path[i]);
+    }
+    
+    return totalEnergy;
+}
+
 bool Optimizer::isPathValid(const std::vector<Point>& path) const {
     for (const Point& point : path) {
         if (!terrain.isPassable(point)) {
@@ -296,7 +1212,6 @@ std::vector<Point> Optimizer::findEnergyOptimalPath(const Point& start, const Po
         
         for (const Point& neighbor : neighbors) {
             double movementCost = terrain.getMovementCost(neighbor);
-            if (movementCost >= 1000.0) continue;
             
             double distance = calculateDistance(current->position, neighbor);
             
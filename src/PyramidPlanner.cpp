@@ -0,0 +1,173 @@
+#include "../include/PyramidPlanner.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+static const double SQRT2 = std::sqrt(2.0);
+
+// 8-directional moves, matching Terrain::getNeighbors
+static const int* const NEIGHBOR_DX = Terrain::DIRECTION_DX;
+static const int* const NEIGHBOR_DY = Terrain::DIRECTION_DY;
+
+PyramidPlanner::PyramidPlanner(CostPyramid& pyramidRef, const PyramidOptions& plannerOptions)
+    : pyramid(pyramidRef), terrain(pyramidRef.getTerrain()), options(plannerOptions),
+      corridorStamp(0), lastPathCost(0.0), expandedNodes(0) {
+    if (options.corridorRadius < 1 || options.finestLevel < 0 || options.partialPenalty < 1.0) {
+        throw std::runtime_error("Invalid pyramid planner options");
+    }
+}
+
+bool PyramidPlanner::markCorridor(int k, const std::vector<Point>& coarser, int radius) {
+    const int width = k == 0 ? terrain.getWidth() : pyramid.level(k).width;
+    const int height = k == 0 ? terrain.getHeight() : pyramid.level(k).height;
+    const int coarseWidth = (width + 1) / 2;
+    const int coarseHeight = (height + 1) / 2;
+    if (radius >= std::max(coarseWidth, coarseHeight)) {
+        return false;
+    }
+
+    size_t cells = static_cast<size_t>(width) * height;
+    if (corridor.size() < cells) {
+        corridor.resize(cells, 0);
+    }
+    if (++corridorStamp == 0) {
+        std::fill(corridor.begin(), corridor.end(), 0);
+        corridorStamp = 1;
+    }
+
+    // Each coarse cell of the widened route opens its 2x2 children
+    for (const Point& block : coarser) {
+        int bx0 = std::max(0, block.x - radius), bx1 = std::min(coarseWidth - 1, block.x + radius);
+        int by0 = std::max(0, block.y - radius), by1 = std::min(coarseHeight - 1, block.y + radius);
+        int y1 = std::min(2 * by1 + 1, height - 1);
+        int x1 = std::min(2 * bx1 + 1, width - 1);
+        for (int y = 2 * by0; y <= y1; y++) {
+            uint32_t* row = corridor.data() + static_cast<size_t>(y) * width;
+            std::fill(row + 2 * bx0, row + x1 + 1, corridorStamp);
+        }
+    }
+    return true;
+}
+
+bool PyramidPlanner::searchLevel(int k, const Point& start, const Point& goal, bool restricted,
+                                 std::vector<Point>& route) {
+    const PyramidLevel* level = k == 0 ? nullptr : &pyramid.level(k);
+    const int width = level ? level->width : terrain.getWidth();
+    const int height = level ? level->height : terrain.getHeight();
+    const double minRate = terrain.getMinCellCost();
+    const double penalty = options.partialPenalty;
+
+    // Cost per unit distance of entering a cell, +infinity if blocked
+    auto rate = [&](int x, int y) {
+        if (!level) {
+            size_t cell = terrain.cellIndex(x, y);
+            return terrain.cellType(cell) == TerrainType::OBSTACLE
+                ? std::numeric_limits<double>::infinity() : terrain.cellCost(cell);
+        }
+        size_t cell = level->cell(x, y);
+        double dearest = level->maxCost[cell];
+        return dearest < std::numeric_limits<float>::infinity()
+            ? dearest : static_cast<double>(level->minCost[cell]) * penalty;
+    };
+    auto heuristic = [&](int x, int y) {
+        double dx = goal.x - x;
+        double dy = goal.y - y;
+        return std::sqrt(dx * dx + dy * dy) * minRate;
+    };
+    auto nodeId = [width](int x, int y) { return static_cast<uint32_t>(static_cast<size_t>(y) * width + x); };
+
+    SearchWorkspace& ws = workspace;
+    ws.prepare(static_cast<size_t>(width) * height);
+
+    const uint32_t goalNode = nodeId(goal.x, goal.y);
+    double startH = heuristic(start.x, start.y);
+    ws.visit(nodeId(start.x, start.y), 0.0, SearchWorkspace::NO_PARENT);
+    ws.push(OpenEntry{startH, startH, start.x, start.y});
+
+    while (!ws.openList.empty()) {
+        OpenEntry current = ws.pop();
+        uint32_t node = nodeId(current.x, current.y);
+        double g = ws.gScore[node];
+        if (current.fCost > g + current.hCost) continue;
+        expandedNodes++;
+
+        if (node == goalNode) {
+            route.clear();
+            for (uint32_t at = node; at != SearchWorkspace::NO_PARENT; at = ws.parent[at]) {
+                route.push_back(Point(static_cast<int>(at % width), static_cast<int>(at / width)));
+            }
+            std::reverse(route.begin(), route.end());
+            lastPathCost = g;
+            return true;
+        }
+
+        for (int d = 0; d < Terrain::DIRECTION_COUNT; d++) {
+            int nx = current.x + NEIGHBOR_DX[d];
+            int ny = current.y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+
+            uint32_t next = nodeId(nx, ny);
+            if (restricted && corridor[next] != corridorStamp) continue;
+            double cost = rate(nx, ny);
+            if (!(cost < std::numeric_limits<double>::infinity())) continue;
+
+            double tentativeGScore = g + cost * ((NEIGHBOR_DX[d] != 0 && NEIGHBOR_DY[d] != 0) ? SQRT2 : 1.0);
+            if (!ws.seen(next) || tentativeGScore < ws.gScore[next]) {
+                ws.visit(next, tentativeGScore, node);
+                double hCost = heuristic(nx, ny);
+                ws.push(OpenEntry{tentativeGScore + hCost, hCost, nx, ny});
+            }
+        }
+    }
+    return false;
+}
+
+std::vector<Point> PyramidPlanner::findPath(const Point& start, const Point& goal) {
+    expandedNodes = 0;
+    lastPathCost = 0.0;
+    if (!terrain.isValidPosition(start) || !terrain.isValidPosition(goal)) {
+        return std::vector<Point>();
+    }
+    pyramid.refresh();
+
+    const int top = pyramid.levelCount() - 1;
+    const int finest = std::min(options.finestLevel, top);
+    auto at = [](const Point& p, int k) { return Point(p.x >> k, p.y >> k); };
+
+    // The coarsest level is a relaxation: failing there means no path
+    std::vector<Point> coarser, route;
+    if (!searchLevel(top, at(start, top), at(goal, top), false, coarser)) {
+        return std::vector<Point>();
+    }
+
+    for (int k = top - 1; k >= finest; k--) {
+        bool found = false;
+        for (int radius = options.corridorRadius; !found; radius *= 2) {
+            if (!markCorridor(k, coarser, radius)) {
+                found = searchLevel(k, at(start, k), at(goal, k), false, route);
+                if (!found) return std::vector<Point>();
+                break;
+            }
+            found = searchLevel(k, at(start, k), at(goal, k), true, route);
+        }
+        coarser.swap(route);
+    }
+
+    if (finest == 0) {
+        return coarser;
+    }
+
+    // Approximate route: the centre cell of each block, with the real
+    // endpoints at both ends
+    std::vector<Point> waypoints;
+    waypoints.reserve(coarser.size());
+    const int half = 1 << (finest - 1);
+    for (const Point& block : coarser) {
+        waypoints.push_back(Point(std::min((block.x << finest) + half, terrain.getWidth() - 1),
+                                  std::min((block.y << finest) + half, terrain.getHeight() - 1)));
+    }
+    waypoints.front() = start;
+    waypoints.back() = goal;
+    return waypoints;
+}
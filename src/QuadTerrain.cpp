@@ -0,0 +1,246 @@
+#include "../include/QuadTerrain.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+QuadTerrain::QuadTerrain(const Terrain& terrain, double valueQuantum)
+    : width(0), height(0), rootSize(1), quantum(valueQuantum) {
+    rebuild(terrain);
+}
+
+QuadTerrain::QuadTerrain(int w, int h, const CostProfile& profile, const RowSource& rows, double valueQuantum)
+    : width(0), height(0), rootSize(1), quantum(valueQuantum) {
+    rebuild(w, h, profile, rows);
+}
+
+void QuadTerrain::rebuild(const Terrain& terrain) {
+    rebuild(terrain.getWidth(), terrain.getHeight(), terrain.getCostProfile(),
+            [&terrain](int y, TerrainType* types, double* elevation, double* wind) {
+                for (int x = 0; x < terrain.getWidth(); x++) {
+                    types[x] = terrain.getTerrain(x, y);
+                    elevation[x] = terrain.getElevation(x, y);
+                    wind[x] = terrain.getWindResistance(x, y);
+                }
+            });
+}
+
+void QuadTerrain::rebuild(int w, int h, const CostProfile& profile, const RowSource& rows) {
+    if (w < 0 || h < 0) {
+        throw std::runtime_error("QuadTerrain dimensions must not be negative");
+    }
+    width = w;
+    height = h;
+    costProfile = profile;
+    
+    rootSize = 1;
+    while (rootSize < width || rootSize < height) {
+        rootSize <<= 1;
+    }
+    
+    nodes.clear();
+    palette.clear();
+    paletteIndex.clear();
+    
+    // Slot 0 is the root; every other node is appended after it
+    nodes.push_back(QuadNode{LEAF, 0});
+    
+    // Collapse each band's blocks as soon as the band is read
+    int blockSize = std::min(rootSize, BAND_ROWS);
+    int blocksX = (width + blockSize - 1) / blockSize;
+    int blocksY = (height + blockSize - 1) / blockSize;
+    std::vector<QuadNode> blockRoots(static_cast<size_t>(blocksX) * blocksY);
+    
+    Band band;
+    size_t bandCells = static_cast<size_t>(width) * blockSize;
+    band.types.resize(bandCells);
+    band.elevation.resize(bandCells);
+    band.wind.resize(bandCells);
+    for (int by = 0; by < blocksY; by++) {
+        band.bandY = by * blockSize;
+        band.rows = std::min(blockSize, height - band.bandY);
+        for (int row = 0; row < band.rows; row++) {
+            size_t offset = static_cast<size_t>(row) * width;
+            rows(band.bandY + row, band.types.data() + offset, band.elevation.data() + offset,
+                 band.wind.data() + offset);
+        }
+        for (int bx = 0; bx < blocksX; bx++) {
+            blockRoots[static_cast<size_t>(by) * blocksX + bx] = buildBlock(band, bx * blockSize, band.bandY, blockSize);
+        }
+    }
+    
+    nodes[0] = buildUpper(blockRoots, blocksX, blockSize, 0, 0, rootSize);
+    nodes.shrink_to_fit();
+    paletteIndex = decltype(paletteIndex)();
+}
+
+uint32_t QuadTerrain::valueOf(TerrainType type, double elevation, double wind) {
+    if (quantum > 0.0) {
+        elevation = std::round(elevation / quantum) * quantum;
+        wind = std::round(wind / quantum) * quantum;
+    }
+    // Adding zero folds -0.0 into 0.0, so equal values share bits
+    elevation += 0.0;
+    wind += 0.0;
+    
+    // Most neighbouring cells repeat the previous value
+    if (!palette.empty()) {
+        const CellValue& last = palette.back();
+        if (last.type == type && last.elevation == elevation && last.windResistance == wind) {
+            return static_cast<uint32_t>(palette.size() - 1);
+        }
+    }
+    
+    CellKey key;
+    std::memcpy(&key.elevation, &elevation, sizeof(double));
+    std::memcpy(&key.wind, &wind, sizeof(double));
+    key.type = static_cast<uint8_t>(type);
+    auto found = paletteIndex.find(key);
+    if (found != paletteIndex.end()) {
+        return found->second;
+    }
+    
+    uint32_t value = static_cast<uint32_t>(palette.size());
+    palette.push_back(CellValue{type, elevation, wind, costProfile.cellCost(type, elevation, wind)});
+    paletteIndex.emplace(key, value);
+    return value;
+}
+
+QuadTerrain::QuadNode QuadTerrain::join(uint32_t first, const QuadNode (&children)[4]) {
+    bool uniform = true;
+    for (const QuadNode& child : children) {
+        if (child.child != LEAF || child.value != children[0].value) {
+            uniform = false;
+            break;
+        }
+    }
+    
+    if (uniform) {
+        // Leaf children have no descendants, so their slots are the last four
+        nodes.resize(first);
+        return QuadNode{LEAF, children[0].value};
+    }
+    
+    std::copy(children, children + 4, nodes.begin() + first);
+    return QuadNode{first, 0};
+}
+
+QuadTerrain::QuadNode QuadTerrain::buildBlock(const Band& band, int x, int y, int size) {
+    if (x >= width || y >= height) {
+        // Squares entirely off the map read like Terrain outside its bounds
+        return QuadNode{LEAF, valueOf(TerrainType::OBSTACLE, 0.0, 0.0)};
+    }
+    if (size == 1) {
+        size_t cell = static_cast<size_t>(y - band.bandY) * width + x;
+        return QuadNode{LEAF, valueOf(band.types[cell], band.elevation[cell], band.wind[cell])};
+    }
+    
+    // Reserve the four children contiguously, then fill them in
+    uint32_t first = static_cast<uint32_t>(nodes.size());
+    nodes.resize(nodes.size() + 4);
+    int half = size / 2;
+    
+    QuadNode children[4] = {
+        buildBlock(band, x, y, half),
+        buildBlock(band, x + half, y, half),
+        buildBlock(band, x, y + half, half),
+        buildBlock(band, x + half, y + half, half),
+    };
+    return join(first, children);
+}
+
+QuadTerrain::QuadNode QuadTerrain::buildUpper(const std::vector<QuadNode>& blockRoots, int blocksX, int blockSize,
+                                              int x, int y, int size) {
+    if (x >= width || y >= height) {
+        return QuadNode{LEAF, valueOf(TerrainType::OBSTACLE, 0.0, 0.0)};
+    }
+    if (size == blockSize) {
+        return blockRoots[static_cast<size_t>(y / blockSize) * blocksX + x / blockSize];
+    }
+    
+    uint32_t first = static_cast<uint32_t>(nodes.size());
+    nodes.resize(nodes.size() + 4);
+    int half = size / 2;
+    
+    QuadNode children[4] = {
+        buildUpper(blockRoots, blocksX, blockSize, x, y, half),
+        buildUpper(blockRoots, blocksX, blockSize, x + half, y, half),
+        buildUpper(blockRoots, blocksX, blockSize, x, y + half, half),
+        buildUpper(blockRoots, blocksX, blockSize, x + half, y + half, half),
+    };
+    return join(first, children);
+}
+
+const QuadTerrain::QuadNode& QuadTerrain::findLeaf(int x, int y, int& leafX, int& leafY, int& leafSize) const {
+    const QuadNode* node = &nodes[0];
+    leafX = 0;
+    leafY = 0;
+    leafSize = rootSize;
+    
+    while (node->child != LEAF) {
+        leafSize /= 2;
+        int quadrant = 0;
+        if (x >= leafX + leafSize) {
+            quadrant |= 1;
+            leafX += leafSize;
+        }
+        if (y >= leafY + leafSize) {
+            quadrant |= 2;
+            leafY += leafSize;
+        }
+        node = &nodes[node->child + quadrant];
+    }
+    return *node;
+}
+
+TerrainType QuadTerrain::getTerrain(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return TerrainType::OBSTACLE;
+    int lx, ly, size;
+    return palette[findLeaf(x, y, lx, ly, size).value].type;
+}
+
+double QuadTerrain::getElevation(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return 0.0;
+    int lx, ly, size;
+    return palette[findLeaf(x, y, lx, ly, size).value].elevation;
+}
+
+double QuadTerrain::getWindResistance(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return 0.0;
+    int lx, ly, size;
+    return palette[findLeaf(x, y, lx, ly, size).value].windResistance;
+}
+
+double QuadTerrain::getMovementCost(const Point& pos) const {
+    if (pos.x < 0 || pos.y < 0 || pos.x >= width || pos.y >= height) return costProfile.obstacleCost;
+    int lx, ly, size;
+    return palette[findLeaf(pos.x, pos.y, lx, ly, size).value].movementCost;
+}
+
+bool QuadTerrain::isPassable(const Point& pos) const {
+    return getTerrain(pos.x, pos.y) != TerrainType::OBSTACLE;
+}
+
+UniformBlock QuadTerrain::largestUniformBlock(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return UniformBlock{x, y, 0, 0, TerrainType::OBSTACLE, costProfile.obstacleCost};
+    }
+    
+    int lx, ly, size;
+    const CellValue& value = palette[findLeaf(x, y, lx, ly, size).value];
+    return UniformBlock{lx, ly, std::min(size, width - lx), std::min(size, height - ly),
+                        value.type, value.movementCost};
+}
+
+size_t QuadTerrain::leafCount() const {
+    // Every internal node has four children: leaves = 3 * internal + 1
+    size_t internal = 0;
+    for (const QuadNode& node : nodes) {
+        if (node.child != LEAF) internal++;
+    }
+    return 3 * internal + 1;
+}
+
+size_t QuadTerrain::memoryBytes() const {
+    return nodes.capacity() * sizeof(QuadNode) + palette.capacity() * sizeof(CellValue);
+}
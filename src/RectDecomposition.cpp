@@ -0,0 +1,141 @@
+#include "../include/RectDecomposition.h"
+#include <algorithm>
+
+RectDecomposition::RectDecomposition(const Terrain& terrainRef)
+    : terrain(terrainRef), liveRects(0), version(0) {
+    rebuild();
+    terrain.addListener(this);
+}
+
+RectDecomposition::~RectDecomposition() {
+    terrain.removeListener(this);
+}
+
+void RectDecomposition::rebuild() {
+    rects.clear();
+    freeIds.clear();
+    liveRects = 0;
+    rectOf.assign(static_cast<size_t>(terrain.getWidth()) * terrain.getHeight(), NO_RECT);
+
+    if (!rectOf.empty()) {
+        decompose(0, 0, terrain.getWidth() - 1, terrain.getHeight() - 1);
+    }
+    version = terrain.getVersion();
+}
+
+uint32_t RectDecomposition::allocateRect(const CostRect& rect) {
+    uint32_t id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+        rects[id] = rect;
+    } else {
+        id = static_cast<uint32_t>(rects.size());
+        rects.push_back(rect);
+    }
+    liveRects++;
+    return id;
+}
+
+void RectDecomposition::label(const CostRect& rect, uint32_t id) {
+    for (int y = rect.y0; y <= rect.y1; y++) {
+        std::fill_n(rectOf.begin() + cell(rect.x0, y), rect.width(), id);
+    }
+}
+
+void RectDecomposition::decompose(int x0, int y0, int x1, int y1) {
+    // Cell can join a rectangle of the given cost
+    auto fits = [&](int x, int y, double cost) {
+        if (rectOf[cell(x, y)] != NO_RECT) return false;
+        size_t i = terrain.cellIndex(x, y);
+        return terrain.cellType(i) != TerrainType::OBSTACLE && terrain.cellCost(i) == cost;
+    };
+
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            size_t i = terrain.cellIndex(x, y);
+            if (rectOf[cell(x, y)] != NO_RECT || terrain.cellType(i) == TerrainType::OBSTACLE) continue;
+
+            CostRect rect{x, y, x, y, terrain.cellCost(i)};
+
+            // Widest run on this row, then every following row that matches it
+            while (rect.x1 < x1 && fits(rect.x1 + 1, y, rect.cost)) {
+                rect.x1++;
+            }
+            while (rect.y1 < y1) {
+                bool rowFits = true;
+                for (int rx = rect.x0; rx <= rect.x1 && rowFits; rx++) {
+                    rowFits = fits(rx, rect.y1 + 1, rect.cost);
+                }
+                if (!rowFits) break;
+                rect.y1++;
+            }
+
+            label(rect, allocateRect(rect));
+            x = rect.x1;
+        }
+    }
+}
+
+void RectDecomposition::onTerrainChanged(int x0, int y0, int x1, int y1) {
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, terrain.getWidth() - 1);
+    y1 = std::min(y1, terrain.getHeight() - 1);
+
+    if (static_cast<size_t>(terrain.getWidth()) * terrain.getHeight() != rectOf.size() ||
+        (x0 == 0 && y0 == 0 && x1 == terrain.getWidth() - 1 && y1 == terrain.getHeight() - 1)) {
+        rebuild();
+        return;
+    }
+    if (x0 > x1 || y0 > y1) {
+        version = terrain.getVersion();
+        return;
+    }
+
+    std::vector<uint32_t> touched;
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            uint32_t id = rectOf[cell(x, y)];
+            if (id != NO_RECT) touched.push_back(id);
+        }
+    }
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+    for (uint32_t id : touched) {
+        const CostRect rect = rects[id];
+        int ix0 = std::max(rect.x0, x0), iy0 = std::max(rect.y0, y0);
+        int ix1 = std::min(rect.x1, x1), iy1 = std::min(rect.y1, y1);
+
+        // Parts of the rectangle outside the edited box stay valid as is
+        std::vector<CostRect> pieces;
+        if (rect.y0 < iy0) pieces.push_back(CostRect{rect.x0, rect.y0, rect.x1, iy0 - 1, rect.cost});
+        if (iy1 < rect.y1) pieces.push_back(CostRect{rect.x0, iy1 + 1, rect.x1, rect.y1, rect.cost});
+        if (rect.x0 < ix0) pieces.push_back(CostRect{rect.x0, iy0, ix0 - 1, iy1, rect.cost});
+        if (ix1 < rect.x1) pieces.push_back(CostRect{ix1 + 1, iy0, rect.x1, iy1, rect.cost});
+
+        if (pieces.empty()) {
+            freeIds.push_back(id);
+            liveRects--;
+            continue;
+        }
+
+        // The largest piece keeps the id, so its cells need no relabelling
+        auto largest = std::max_element(pieces.begin(), pieces.end(), [](const CostRect& a, const CostRect& b) {
+            return static_cast<long long>(a.width()) * a.height() < static_cast<long long>(b.width()) * b.height();
+        });
+        rects[id] = *largest;
+        for (auto piece = pieces.begin(); piece != pieces.end(); ++piece) {
+            if (piece != largest) {
+                label(*piece, allocateRect(*piece));
+            }
+        }
+    }
+
+    for (int y = y0; y <= y1; y++) {
+        std::fill_n(rectOf.begin() + cell(x0, y), x1 - x0 + 1, NO_RECT);
+    }
+    decompose(x0, y0, x1, y1);
+    version = terrain.getVersion();
+}
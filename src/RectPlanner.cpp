@@ -0,0 +1,166 @@
+#include "../include/RectPlanner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+static const double SQRT2 = std::sqrt(2.0);
+
+// 8-directional moves, matching Terrain::getNeighbors
+static const int NEIGHBOR_DX[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+static const int NEIGHBOR_DY[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+// Length of the shortest 8-connected walk covering (dx, dy)
+static double octileDistance(int dx, int dy) {
+    dx = std::abs(dx);
+    dy = std::abs(dy);
+    return SQRT2 * std::min(dx, dy) + std::abs(dx - dy);
+}
+
+RectPlanner::RectPlanner(const RectDecomposition& decomposition)
+    : rects(decomposition), terrain(decomposition.getTerrain()), expandedNodes(0) {}
+
+void RectPlanner::appendSegment(std::vector<Point>& path, const Point& a, const Point& b) {
+    Point current = a;
+    while (!(current == b)) {
+        if (current.x != b.x) current.x += b.x > current.x ? 1 : -1;
+        if (current.y != b.y) current.y += b.y > current.y ? 1 : -1;
+        path.push_back(current);
+    }
+}
+
+std::vector<Point> RectPlanner::findPath(const Point& start, const Point& goal) {
+    expandedNodes = 0;
+    if (!terrain.isValidPosition(start) || !terrain.isValidPosition(goal)) {
+        return std::vector<Point>();
+    }
+    if (!rects.isCurrent()) {
+        throw std::runtime_error("Rectangle decomposition is out of date with its terrain");
+    }
+
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    auto nodeId = [width](int x, int y) { return static_cast<uint32_t>(static_cast<size_t>(y) * width + x); };
+
+    SearchWorkspace& ws = workspace;
+    ws.prepare(static_cast<size_t>(width) * height);
+
+    const uint32_t goalNode = nodeId(goal.x, goal.y);
+    const uint32_t goalRect = rects.rectAt(goal.x, goal.y);
+
+    double startH = terrain.getHeuristicCost(start, goal);
+    ws.visit(nodeId(start.x, start.y), 0.0, SearchWorkspace::NO_PARENT);
+    ws.push(OpenEntry{startH, startH, start.x, start.y});
+
+    while (!ws.openList.empty()) {
+        OpenEntry current = ws.pop();
+        uint32_t node = nodeId(current.x, current.y);
+
+        if (node == goalNode) {
+            std::vector<Point> corners;
+            for (uint32_t n = node; n != SearchWorkspace::NO_PARENT; n = ws.parent[n]) {
+                corners.push_back(Point(static_cast<int>(n % width), static_cast<int>(n / width)));
+            }
+            std::reverse(corners.begin(), corners.end());
+
+            std::vector<Point> path(1, corners[0]);
+            for (size_t i = 1; i < corners.size(); i++) {
+                appendSegment(path, corners[i - 1], corners[i]);
+            }
+            return path;
+        }
+
+        // Skip entries superseded by a cheaper path to the same cell
+        double g = ws.gScore[node];
+        if (current.fCost > g + current.hCost) continue;
+        expandedNodes++;
+
+        auto relax = [&](int x, int y, double edgeCost) {
+            uint32_t next = nodeId(x, y);
+            double tentativeGScore = g + edgeCost;
+            if (!ws.seen(next) || tentativeGScore < ws.gScore[next]) {
+                ws.visit(next, tentativeGScore, node);
+                double hCost = terrain.getHeuristicCost(Point(x, y), goal);
+                ws.push(OpenEntry{tentativeGScore + hCost, hCost, x, y});
+            }
+        };
+
+        const int x = current.x;
+        const int y = current.y;
+        const uint32_t id = rects.rectAt(x, y);
+        const CostRect* rect = id != RectDecomposition::NO_RECT ? &rects.getRect(id) : nullptr;
+
+        if (rect) {
+            const double cost = rect->cost;
+
+            // The goal is reachable in a straight octile run from anywhere in its rectangle
+            if (id == goalRect) {
+                relax(goal.x, goal.y, cost * octileDistance(goal.x - x, goal.y - y));
+            }
+
+            // Only the start can be an interior node: link it to the whole perimeter
+            if (!rect->onPerimeter(x, y)) {
+                for (int px = rect->x0; px <= rect->x1; px++) {
+                    relax(px, rect->y0, cost * octileDistance(px - x, rect->y0 - y));
+                    relax(px, rect->y1, cost * octileDistance(px - x, rect->y1 - y));
+                }
+                for (int py = rect->y0 + 1; py < rect->y1; py++) {
+                    relax(rect->x0, py, cost * octileDistance(rect->x0 - x, py - y));
+                    relax(rect->x1, py, cost * octileDistance(rect->x1 - x, py - y));
+                }
+                continue;
+            }
+        }
+
+        // Ordinary grid moves, except into the interior of our own rectangle
+        for (int d = 0; d < 8; d++) {
+            int nx = x + NEIGHBOR_DX[d];
+            int ny = y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            if (rect && rect->contains(nx, ny) && !rect->onPerimeter(nx, ny)) continue;
+
+            size_t next = terrain.cellIndex(nx, ny);
+            if (terrain.cellType(next) == TerrainType::OBSTACLE) continue;
+
+            double distance = (nx != x && ny != y) ? SQRT2 : 1.0;
+            relax(nx, ny, terrain.cellCost(next) * distance);
+        }
+
+        if (!rect) continue;
+
+        // Macro edges across the rectangle. From a perimeter cell at depth
+        // D from the opposite side: every opposite-side cell within D rows
+        // (a taut octile run), plus the two diagonal rays into the interior,
+        // which end on an adjacent side. Walking along the perimeter and
+        // then taking one of these covers every perimeter-to-perimeter
+        // crossing at its octile cost. Depths below 2 are ordinary moves.
+        const double cost = rect->cost;
+        int depthX = rect->x1 - rect->x0;
+        if (depthX >= 2 && (x == rect->x0 || x == rect->x1)) {
+            int sx = x == rect->x0 ? 1 : -1;
+            int ox = x + sx * depthX;
+            for (int py = std::max(rect->y0, y - depthX); py <= std::min(rect->y1, y + depthX); py++) {
+                relax(ox, py, cost * octileDistance(depthX, py - y));
+            }
+            for (int sy = -1; sy <= 1; sy += 2) {
+                int k = std::min(depthX, sy < 0 ? y - rect->y0 : rect->y1 - y);
+                if (k >= 2) relax(x + sx * k, y + sy * k, cost * SQRT2 * k);
+            }
+        }
+
+        int depthY = rect->y1 - rect->y0;
+        if (depthY >= 2 && (y == rect->y0 || y == rect->y1)) {
+            int sy = y == rect->y0 ? 1 : -1;
+            int oy = y + sy * depthY;
+            for (int px = std::max(rect->x0, x - depthY); px <= std::min(rect->x1, x + depthY); px++) {
+                relax(px, oy, cost * octileDistance(px - x, depthY));
+            }
+            for (int sx = -1; sx <= 1; sx += 2) {
+                int k = std::min(depthY, sx < 0 ? x - rect->x0 : rect->x1 - x);
+                if (k >= 2) relax(x + sx * k, y + sy * k, cost * SQRT2 * k);
+            }
+        }
+    }
+
+    return std::vector<Point>(); // Empty path = no solution
+}
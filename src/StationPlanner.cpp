@@ -0,0 +1,200 @@
+#include "../include/StationPlanner.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+// 8-directional moves, matching Terrain::getNeighbors
+static const int* const NEIGHBOR_DX = Terrain::DIRECTION_DX;
+static const int* const NEIGHBOR_DY = Terrain::DIRECTION_DY;
+static const double NEIGHBOR_DISTANCE[8] = {
+    std::sqrt(2.0), 1.0, std::sqrt(2.0), 1.0, 1.0, std::sqrt(2.0), 1.0, std::sqrt(2.0)
+};
+
+StationPlanner::StationPlanner(const Terrain& terrainRef, double range, unsigned threadCount)
+    : terrain(terrainRef), legRange(range), threads(threadCount), version(0), built(false), optimizer(terrainRef) {
+    if (!(range > 0.0)) {
+        throw std::runtime_error("Station leg range must be positive");
+    }
+    terrain.addListener(this);
+    build();
+}
+
+StationPlanner::~StationPlanner() {
+    terrain.removeListener(this);
+}
+
+void StationPlanner::onTerrainChanged(int, int, int, int) {
+    // A cost change anywhere can shorten or break any link
+    built = false;
+}
+
+void StationPlanner::refresh() {
+    if (!isCurrent()) build();
+}
+
+size_t StationPlanner::linkCount() const {
+    size_t total = 0;
+    for (const std::vector<StationLink>& out : links) {
+        total += out.size();
+    }
+    return total;
+}
+
+void StationPlanner::build() {
+    stations = terrain.getEnergyStations();
+    stationOf.assign(terrain.cellCount(), NO_STATION);
+    for (size_t i = 0; i < stations.size(); i++) {
+        stationOf[terrain.cellIndex(stations[i].x, stations[i].y)] = static_cast<uint32_t>(i);
+    }
+    links.assign(stations.size(), std::vector<StationLink>());
+    version = terrain.getVersion();
+    built = true;
+
+    // One bounded search per station; each thread reuses one workspace
+    unsigned workers = threads != 0 ? threads : (stations.size() >= 8 ? defaultThreadCount() : 1);
+    parallelFor(0, stations.size(), workers, [&](size_t begin, size_t end, unsigned) {
+        SearchWorkspace ws;
+        for (size_t i = begin; i < end; i++) {
+            reachStations(stations[i], legRange, true, ws, links[i]);
+        }
+    });
+}
+
+void StationPlanner::reachStations(const Point& origin, double budget, bool forward, SearchWorkspace& ws,
+                                   std::vector<StationLink>& reached) const {
+    reached.clear();
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    const uint32_t originCell = static_cast<uint32_t>(terrain.cellIndex(origin.x, origin.y));
+
+    ws.prepare(terrain.cellCount());
+    ws.visit(originCell, 0.0, SearchWorkspace::NO_PARENT);
+    ws.push(OpenEntry{0.0, 0.0, origin.x, origin.y});
+
+    while (!ws.openList.empty() && ws.openList.front().fCost <= budget) {
+        OpenEntry current = ws.pop();
+        uint32_t cell = static_cast<uint32_t>(terrain.cellIndex(current.x, current.y));
+        double g = ws.gScore[cell];
+        if (current.fCost > g) continue;
+
+        if (stationOf[cell] != NO_STATION && cell != originCell) {
+            reached.push_back(StationLink{stationOf[cell], g});
+        }
+        // A backward search from an obstacle goal has nowhere to come from
+        if (!forward && terrain.cellType(cell) == TerrainType::OBSTACLE) continue;
+
+        // Forward, a move costs the cell it enters; backward, every move
+        // into this cell costs the same
+        double rate = forward ? 0.0 : terrain.cellCost(cell);
+        for (int d = 0; d < 8; d++) {
+            int nx = current.x + NEIGHBOR_DX[d];
+            int ny = current.y + NEIGHBOR_DY[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+
+            size_t next = terrain.cellIndex(nx, ny);
+            if (terrain.cellType(next) == TerrainType::OBSTACLE) continue;
+
+            double tentative = g + (forward ? terrain.cellCost(next) : rate) * NEIGHBOR_DISTANCE[d];
+            if (!ws.seen(next) || tentative < ws.gScore[next]) {
+                ws.visit(next, tentative, cell);
+                ws.push(OpenEntry{tentative, 0.0, nx, ny});
+            }
+        }
+    }
+}
+
+StationRoute StationPlanner::findRoute(const Point& start, const Point& goal, double startEnergy) {
+    StationRoute route;
+    if (!terrain.isValidPosition(start) || !terrain.isValidPosition(goal) || !(startEnergy >= 0.0)) {
+        return route;
+    }
+    refresh();
+
+    const double unreachable = std::numeric_limits<double>::infinity();
+    const size_t count = stations.size();
+    const uint32_t goalNode = static_cast<uint32_t>(count);
+    const uint32_t startStation = stationOf[terrain.cellIndex(start.x, start.y)];
+
+    // Join the endpoints. A search back from the goal settles every cell
+    // it reaches within its budget, so it also yields the direct leg.
+    SearchWorkspace ws;
+    std::vector<StationLink> reached;
+    std::vector<double> toGoal(count, unreachable);
+    reachStations(goal, std::max(legRange, startEnergy), false, ws, reached);
+    for (const StationLink& link : reached) {
+        if (link.energy <= legRange) toGoal[link.to] = link.energy;
+    }
+    size_t startCell = terrain.cellIndex(start.x, start.y);
+    double directEnergy = ws.seen(startCell) ? ws.gScore[startCell] : unreachable;
+
+    std::vector<double> energy(count + 1, unreachable);
+    std::vector<uint32_t> parent(count + 1, NO_STATION);
+    if (directEnergy <= startEnergy) {
+        energy[goalNode] = directEnergy;
+    }
+    if (startStation != NO_STATION && startEnergy < legRange) {
+        energy[startStation] = 0.0; // Top up before leaving
+    }
+    reachStations(start, startEnergy, true, ws, reached);
+    for (const StationLink& link : reached) {
+        energy[link.to] = std::min(energy[link.to], link.energy);
+    }
+
+    // Dijkstra over the stations, with the goal as one more node
+    typedef std::pair<double, uint32_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    for (uint32_t node = 0; node <= goalNode; node++) {
+        if (energy[node] < unreachable) open.push(Entry(energy[node], node));
+    }
+    while (!open.empty()) {
+        Entry current = open.top();
+        open.pop();
+        uint32_t node = current.second;
+        if (current.first > energy[node]) continue;
+        if (node == goalNode) break;
+
+        auto relax = [&](uint32_t to, double legEnergy) {
+            double total = current.first + legEnergy;
+            if (total < energy[to]) {
+                energy[to] = total;
+                parent[to] = node;
+                open.push(Entry(total, to));
+            }
+        };
+        for (const StationLink& link : links[node]) {
+            relax(link.to, link.energy);
+        }
+        if (toGoal[node] < unreachable) {
+            relax(goalNode, toGoal[node]);
+        }
+    }
+    if (!(energy[goalNode] < unreachable)) {
+        return route;
+    }
+
+    // Recharge stops in flight order, then A* for each leg between them
+    for (uint32_t node = parent[goalNode]; node != NO_STATION; node = parent[node]) {
+        route.stops.push_back(stations[node]);
+    }
+    std::reverse(route.stops.begin(), route.stops.end());
+
+    std::vector<Point> waypoints;
+    waypoints.push_back(start);
+    waypoints.insert(waypoints.end(), route.stops.begin(), route.stops.end());
+    waypoints.push_back(goal);
+    route.path.push_back(start);
+    for (size_t i = 0; i + 1 < waypoints.size(); i++) {
+        if (waypoints[i] == waypoints[i + 1]) continue; // Topped up at the start
+        std::vector<Point> leg = optimizer.findPathAStar(waypoints[i], waypoints[i + 1]);
+        if (leg.empty()) {
+            return StationRoute(); // Cannot happen while the graph is current
+        }
+        route.path.insert(route.path.end(), leg.begin() + 1, leg.end());
+    }
+    route.energy = energy[goalNode];
+    return route;
+}
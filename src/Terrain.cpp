@@ -1,56 +1,602 @@
 #include "../include/Terrain.h"
+#include "../include/BinaryMapFormat.h"
+#include "../include/Parallel.h"
+#include "../include/CounterRng.h"
 #include <iostream>
+#include <stdexcept>
 #include <random>
 #include <iomanip>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 // ANSI color codes for green terminal output
 #define RESET   "\033[0m"
 #define GREEN   "\033[32m"
 #define BRIGHT_GREEN "\033[1;32m"
 
-Terrain::Terrain(int w, int h) : width(w), height(h) {
-    grid.resize(height, std::vector<TerrainType>(width, TerrainType::NORMAL));
-    elevationMap.resize(height, std::vector<double>(width, 0.0));
-    windResistance.resize(height, std::vector<double>(width, 0.0));
+CostProfile::CostProfile()
+    : obstacleCost(DEFAULT_OBSTACLE_COST), elevationFactor(0.5), windFactor(0.3),
+      headwindFactor(DEFAULT_HEADWIND_FACTOR), minWindScale(DEFAULT_MIN_WIND_SCALE) {
+    for (int i = 0; i < TYPE_SLOTS; i++) {
+        typeCost[i] = DEFAULT_NORMAL_COST;
+    }
+    setTypeCost(TerrainType::HILL, DEFAULT_HILL_COST);
+    setTypeCost(TerrainType::WIND_ZONE, DEFAULT_WIND_COST);
+    setTypeCost(TerrainType::ENERGY_STATION, DEFAULT_ENERGY_STATION_COST);
+    setTypeCost(TerrainType::DANGER_ZONE, DEFAULT_DANGER_ZONE_COST);
+}
+
+uint64_t CostProfile::fingerprint() const {
+    // FNV-1a over the raw parameter bytes
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](double value) {
+        unsigned char bytes[sizeof(double)];
+        std::memcpy(bytes, &value, sizeof(bytes));
+        for (unsigned char b : bytes) {
+            hash = (hash ^ b) * 1099511628211ULL;
+        }
+    };
+    
+    for (int i = 0; i < TYPE_SLOTS; i++) {
+        mix(typeCost[i]);
+    }
+    mix(obstacleCost);
+    mix(elevationFactor);
+    mix(windFactor);
+    return hash;
+}
+
+Terrain::Terrain(int w, int h, const CostProfile& profile, CellEncoding cellEncoding)
+    : width(w), height(h), encoding(cellEncoding), layout(CellLayout::ROW_MAJOR), tilesX(0),
+      costProfile(profile), minEdgeRate(0.0), version(0),
+      batchDepth(0), dirtyX0(0), dirtyY0(0), dirtyX1(-1), dirtyY1(-1), sumsStaleX(0), sumsStaleY(0) {
+    size_t cells = static_cast<size_t>(width) * height;
+    minCellCost = costProfile.cellCost(TerrainType::NORMAL, 0.0, 0.0);
+    
+    if (encoding == CellEncoding::PACKED) {
+        packedCells.allocate(cells, packCell(TerrainType::NORMAL, 0.0, 0.0));
+        return;
+    }
+    grid.allocate(cells, TerrainType::NORMAL);
+    elevationMap.allocate(cells, 0.0);
+    windResistance.allocate(cells, 0.0);
+    costLayer.allocate(cells, minCellCost);
+}
+
+Terrain& Terrain::operator=(const Terrain& other) {
+    if (this != &other) {
+        Terrain copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+Terrain& Terrain::operator=(Terrain&& other) {
+    if (this == &other) return *this;
+    grid = std::move(other.grid);
+    elevationMap = std::move(other.elevationMap);
+    windResistance = std::move(other.windResistance);
+    width = other.width;
+    height = other.height;
+    encoding = other.encoding;
+    packedCells = std::move(other.packedCells);
+    layout = other.layout;
+    tilesX = other.tilesX;
+    costProfile = other.costProfile;
+    costLayer = std::move(other.costLayer);
+    minCellCost = other.minCellCost;
+    windField = std::move(other.windField);
+    edgeCosts = std::move(other.edgeCosts);
+    minEdgeRate = other.minEdgeRate;
+    costSums = std::move(other.costSums);
+    obstacleSums = std::move(other.obstacleSums);
+    sumsStaleX = other.sumsStaleX;
+    sumsStaleY = other.sumsStaleY;
+    
+    // The size may have changed, so listeners hear of it now even inside a
+    // batch; the batch itself stays open and still reports at endBatch
+    version = std::max(version, other.version);
+    notifyChanged(0, 0, width - 1, height - 1);
+    return *this;
+}
+
+Terrain Terrain::fromBinaryFile(const std::string& filename, const CostProfile& profile) {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(filename);
+    
+    if (file->size() < UAVMAP_V1_HEADER_SIZE || !hasUavMapMagic(file->data(), file->size())) {
+        throw std::runtime_error("Not a binary UAV map: " + filename);
+    }
+    
+    UavMapHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(&header, file->data(), UAVMAP_V1_HEADER_SIZE);
+    
+    if (header.endianTag != UAVMAP_ENDIAN_TAG) {
+        throw std::runtime_error("Binary map has foreign byte order: " + filename);
+    }
+    
+    bool isV1 = header.version == 1 && header.headerSize == UAVMAP_V1_HEADER_SIZE;
+    bool isV2 = header.version == UAVMAP_VERSION && header.headerSize == sizeof(UavMapHeader) &&
+                file->size() >= sizeof(UavMapHeader);
+    if (!isV1 && !isV2) {
+        throw std::runtime_error("Unsupported binary map version in: " + filename);
+    }
+    if (isV2) {
+        std::memcpy(&header, file->data(), sizeof(header));
+    }
+    
+    // Two 32-bit sides cannot overflow the product. The type layer alone
+    // needs a byte per cell, so the file size bounds cells before any
+    // offset arithmetic; a mappable file is far below 2^59 bytes, which
+    // keeps the canonical offsets (about 25 bytes per cell) from wrapping.
+    uint64_t cells = static_cast<uint64_t>(header.width) * header.height;
+    if (header.width == 0 || header.height == 0 ||
+        header.width > INT32_MAX || header.height > INT32_MAX ||
+        cells > file->size()) {
+        throw std::runtime_error("Corrupt binary map layout in: " + filename);
+    }
+    
+    // Offsets must match the canonical layout so the layers are aligned
+    UavMapHeader expected = makeUavMapHeader(header.width, header.height, header.version);
+    uint64_t lastLayer = isV2 ? header.costOffset : header.windOffset;
+    if (header.typeOffset != expected.typeOffset ||
+        header.elevationOffset != expected.elevationOffset ||
+        header.windOffset != expected.windOffset ||
+        header.costOffset != expected.costOffset ||
+        lastLayer > file->size() ||
+        cells > (file->size() - lastLayer) / sizeof(double)) {
+        throw std::runtime_error("Corrupt binary map layout in: " + filename);
+    }
+    
+    // Type bytes index the cost profile, so each must name a TerrainType
+    const uint8_t* types = reinterpret_cast<const uint8_t*>(file->data() + header.typeOffset);
+    uint8_t outOfRange = 0;
+    for (uint64_t i = 0; i < cells; i++) {
+        outOfRange |= isTerrainTypeByte(types[i]) ? 0 : 1;
+    }
+    if (outOfRange) {
+        throw std::runtime_error("Invalid terrain type in binary map: " + filename);
+    }
+    
+    Terrain terrain(0, 0, profile);
+    terrain.width = static_cast<int>(header.width);
+    terrain.height = static_cast<int>(header.height);
+    terrain.grid.attach(file, header.typeOffset, cells);
+    terrain.elevationMap.attach(file, header.elevationOffset, cells);
+    terrain.windResistance.attach(file, header.windOffset, cells);
+    
+    // Reuse the baked cost layer only if it was built with this profile
+    if (isV2 && header.costFingerprint == profile.fingerprint()) {
+        terrain.costLayer.attach(file, header.costOffset, cells);
+        terrain.minCellCost = header.minCellCost;
+    } else {
+        terrain.rebuildCostLayer();
+    }
+    return terrain;
+}
+
+void Terrain::addListener(TerrainListener* listener) const {
+    if (std::find(listeners.items.begin(), listeners.items.end(), listener) == listeners.items.end()) {
+        listeners.items.push_back(listener);
+    }
+}
+
+void Terrain::removeListener(TerrainListener* listener) const {
+    listeners.items.erase(std::remove(listeners.items.begin(), listeners.items.end(), listener),
+                          listeners.items.end());
+}
+
+void Terrain::notifyChanged(int x0, int y0, int x1, int y1) {
+    version++;
+    for (TerrainListener* listener : listeners.items) {
+        listener->onTerrainChanged(x0, y0, x1, y1);
+    }
+}
+
+void Terrain::markChanged(int x0, int y0, int x1, int y1) {
+    sumsStaleX = std::min(sumsStaleX, x0);
+    sumsStaleY = std::min(sumsStaleY, y0);
+    
+    if (batchDepth == 0) {
+        notifyChanged(x0, y0, x1, y1);
+        return;
+    }
+    if (dirtyX0 > dirtyX1) {
+        dirtyX0 = x0; dirtyY0 = y0; dirtyX1 = x1; dirtyY1 = y1;
+    } else {
+        dirtyX0 = std::min(dirtyX0, x0);
+        dirtyY0 = std::min(dirtyY0, y0);
+        dirtyX1 = std::max(dirtyX1, x1);
+        dirtyY1 = std::max(dirtyY1, y1);
+    }
+}
+
+void Terrain::beginBatch() {
+    batchDepth++;
+}
+
+void Terrain::endBatch() {
+    if (batchDepth == 0) {
+        throw std::runtime_error("endBatch without beginBatch");
+    }
+    if (--batchDepth > 0 || dirtyX0 > dirtyX1) return;
+    
+    int x0 = dirtyX0, y0 = dirtyY0, x1 = dirtyX1, y1 = dirtyY1;
+    dirtyX0 = dirtyY0 = 0;
+    dirtyX1 = dirtyY1 = -1;
+    notifyChanged(x0, y0, x1, y1);
+}
+
+void Terrain::resizeRows(int newHeight) {
+    newHeight = std::max(0, newHeight);
+    size_t cells = static_cast<size_t>(width) * newHeight;
+    grid.resize(cells, TerrainType::NORMAL);
+    elevationMap.resize(cells, 0.0);
+    windResistance.resize(cells, 0.0);
+    
+    double normalCost = costProfile.cellCost(TerrainType::NORMAL, 0.0, 0.0);
+    costLayer.resize(cells, normalCost);
+    if (newHeight > height) {
+        minCellCost = std::min(minCellCost, normalCost);
+    }
+    height = newHeight;
+}
+
+void Terrain::setLayout(CellLayout newLayout) {
+    if (newLayout == layout) return;
+    
+    int newTilesX = (width + TILE_MASK) >> TILE_BITS;
+    int newTilesY = (height + TILE_MASK) >> TILE_BITS;
+    size_t newCells = newLayout == CellLayout::ROW_MAJOR
+        ? static_cast<size_t>(width) * height
+        : static_cast<size_t>(newTilesX) * newTilesY * TILE_SIZE * TILE_SIZE;
+    
+    // Padding cells outside the map stay NORMAL and are never addressed
+    auto reorder = [&](auto& layer, const auto& fill) {
+        if (layer.size() == 0) return; // Unused in the current encoding
+        std::decay_t<decltype(layer)> reordered;
+        reordered.allocate(newCells, fill);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                reordered[layoutIndex(newLayout, width, newTilesX, x, y)] = layer[index(x, y)];
+            }
+        }
+        layer = std::move(reordered);
+    };
+    
+    reorder(grid, TerrainType::NORMAL);
+    reorder(elevationMap, 0.0);
+    reorder(windResistance, 0.0);
+    reorder(costLayer, costProfile.cellCost(TerrainType::NORMAL, 0.0, 0.0));
+    reorder(packedCells, packCell(TerrainType::NORMAL, 0.0, 0.0));
+    reorder(windField, WindVector{0.0f, 0.0f});
+    reorder(edgeCosts, DirectionalCosts());
+    
+    layout = newLayout;
+    tilesX = newTilesX;
+    
+    // Values are unchanged, but anything indexed by cellIndex must reorder
+    markChanged(0, 0, width - 1, height - 1);
+}
+
+uint32_t Terrain::packCell(TerrainType type, double elevation, double wind) {
+    auto quantize = [](double value) -> uint32_t {
+        if (!(value > 0.0)) return 0; // Negative and NaN clamp to zero
+        if (value >= PACKED_VALUE_MAX) return PACKED_VALUE_MASK;
+        return static_cast<uint32_t>(std::lround(value / PACKED_VALUE_STEP));
+    };
+    
+    return (static_cast<uint32_t>(type) & 0xF) | (quantize(elevation) << 4) | (quantize(wind) << 18);
+}
+
+void Terrain::setEncoding(CellEncoding newEncoding) {
+    if (newEncoding == encoding) return;
+    
+    size_t cells = cellCount();
+    if (newEncoding == CellEncoding::PACKED) {
+        packedCells.allocate(cells, 0);
+        for (size_t i = 0; i < cells; i++) {
+            packedCells[i] = packCell(grid[i], elevationMap[i], windResistance[i]);
+        }
+        grid = TerrainLayer<TerrainType>();
+        elevationMap = TerrainLayer<double>();
+        windResistance = TerrainLayer<double>();
+        costLayer = TerrainLayer<double>();
+        encoding = CellEncoding::PACKED;
+    } else {
+        grid.allocate(cells, TerrainType::NORMAL);
+        elevationMap.allocate(cells, 0.0);
+        windResistance.allocate(cells, 0.0);
+        unpackCells(0, cells, grid.data(), elevationMap.data(), windResistance.data());
+        packedCells = TerrainLayer<uint32_t>();
+        encoding = CellEncoding::FULL;
+    }
+    
+    // Quantization can shift costs slightly; refresh layer and bound
+    rebuildCostLayer();
+    markChanged(0, 0, width - 1, height - 1);
+}
+
+void Terrain::unpackCells(size_t first, size_t count, TerrainType* types, double* elevation, double* wind) const {
+    if (encoding == CellEncoding::FULL) {
+        if (types) std::copy_n(grid.data() + first, count, types);
+        if (elevation) std::copy_n(elevationMap.data() + first, count, elevation);
+        if (wind) std::copy_n(windResistance.data() + first, count, wind);
+        return;
+    }
+    
+    const uint32_t* cells = packedCells.data() + first;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t cell = cells[i];
+        if (types) types[i] = packedType(cell);
+        if (elevation) elevation[i] = packedElevation(cell);
+        if (wind) wind[i] = packedWind(cell);
+    }
+}
+
+Point Terrain::cellPoint(size_t cell) const {
+    if (layout == CellLayout::ROW_MAJOR) {
+        return Point(static_cast<int>(cell % width), static_cast<int>(cell / width));
+    }
+    
+    size_t tile = cell >> (2 * TILE_BITS);
+    int inner = static_cast<int>(cell & ((1 << (2 * TILE_BITS)) - 1));
+    int x = 0, y = 0;
+    for (int bit = 0; bit < TILE_BITS; bit++) {
+        x |= ((inner >> (2 * bit)) & 1) << bit;
+        y |= ((inner >> (2 * bit + 1)) & 1) << bit;
+    }
+    return Point(static_cast<int>(tile % tilesX) * TILE_SIZE + x,
+                 static_cast<int>(tile / tilesX) * TILE_SIZE + y);
+}
+
+void Terrain::reserveRows(int rows) {
+    size_t cells = static_cast<size_t>(width) * std::max(0, rows);
+    grid.reserve(cells);
+    elevationMap.reserve(cells);
+    windResistance.reserve(cells);
+    costLayer.reserve(cells);
+}
+
+void Terrain::trimRows() {
+    grid.shrinkToFit();
+    elevationMap.shrinkToFit();
+    windResistance.shrinkToFit();
+    costLayer.shrinkToFit();
+}
+
+void Terrain::setCostProfile(const CostProfile& profile) {
+    costProfile = profile;
+    rebuildCostLayer();
+    markChanged(0, 0, width - 1, height - 1);
+}
+
+void Terrain::rebuildCostLayer() {
+    sumsStaleX = sumsStaleY = 0;
+    
+    if (encoding == CellEncoding::PACKED) {
+        // Costs are derived on the fly; only the lower bound needs a refresh
+        minCellCost = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < packedCells.size(); i++) {
+            if (packedType(packedCells[i]) != TerrainType::OBSTACLE) {
+                minCellCost = std::min(minCellCost, cellCost(i));
+            }
+        }
+        if (std::isinf(minCellCost)) {
+            minCellCost = 0.0;
+        }
+        if (hasWindField()) rebuildEdgeCosts();
+        return;
+    }
+    
+    size_t cells = grid.size();
+    if (costLayer.isMapped() || costLayer.size() != cells) {
+        costLayer.allocate(cells, 0.0);
+    }
+    
+    // Large maps are baked in parallel chunks, each tracking its own minimum
+    unsigned threads = cells >= (1u << 22) ? defaultThreadCount() : 1;
+    std::vector<double> chunkMin(std::max(1u, threads), std::numeric_limits<double>::infinity());
+    
+    parallelFor(0, cells, threads, [&](size_t begin, size_t end, unsigned chunk) {
+        const TerrainType* types = grid.data();
+        const double* elevation = elevationMap.data();
+        const double* wind = windResistance.data();
+        double* cost = costLayer.data();
+        double localMin = std::numeric_limits<double>::infinity();
+        
+        for (size_t i = begin; i < end; i++) {
+            cost[i] = costProfile.cellCost(types[i], elevation[i], wind[i]);
+            if (types[i] != TerrainType::OBSTACLE) {
+                localMin = std::min(localMin, cost[i]);
+            }
+        }
+        chunkMin[chunk] = localMin;
+    });
+    
+    minCellCost = *std::min_element(chunkMin.begin(), chunkMin.end());
+    if (std::isinf(minCellCost)) {
+        minCellCost = 0.0; // No passable cells
+    }
+    if (hasWindField()) rebuildEdgeCosts();
+}
+
+float Terrain::computeEdgeCost(int x, int y, int direction) const {
+    int dx = DIRECTION_DX[direction];
+    int dy = DIRECTION_DY[direction];
+    int nx = x + dx;
+    int ny = y + dy;
+    if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+        return std::numeric_limits<float>::infinity();
+    }
+    size_t to = index(nx, ny);
+    if (cellType(to) == TerrainType::OBSTACLE) {
+        return std::numeric_limits<float>::infinity();
+    }
+    
+    // Headwind: component of the mean wind along the move, against it
+    double distance = (dx != 0 && dy != 0) ? std::sqrt(2.0) : 1.0;
+    const WindVector& from = windField[index(x, y)];
+    const WindVector& into = windField[to];
+    double headwind = -((from.x + into.x) * dx + (from.y + into.y) * dy) / (2.0 * distance);
+    return static_cast<float>(cellCost(to) * distance * costProfile.windScale(headwind));
+}
+
+void Terrain::rebuildEdgeCosts() {
+    DirectionalCosts blocked;
+    std::fill_n(blocked.cost, DIRECTION_COUNT, std::numeric_limits<float>::infinity());
+    if (edgeCosts.size() != cellCount()) {
+        edgeCosts.allocate(cellCount(), blocked); // Padding cells stay blocked
+    }
+    
+    // Rows are independent; each chunk tracks its own cheapest rate
+    unsigned threads = cellCount() >= (1u << 20) ? defaultThreadCount() : 1;
+    std::vector<double> chunkMin(std::max(1u, threads), std::numeric_limits<double>::infinity());
+    
+    parallelFor(0, height, threads, [&](size_t begin, size_t end, unsigned chunk) {
+        double localMin = std::numeric_limits<double>::infinity();
+        for (int y = static_cast<int>(begin); y < static_cast<int>(end); y++) {
+            for (int x = 0; x < width; x++) {
+                DirectionalCosts& costs = edgeCosts[index(x, y)];
+                for (int d = 0; d < DIRECTION_COUNT; d++) {
+                    costs.cost[d] = computeEdgeCost(x, y, d);
+                    double distance = (DIRECTION_DX[d] != 0 && DIRECTION_DY[d] != 0) ? std::sqrt(2.0) : 1.0;
+                    localMin = std::min(localMin, costs.cost[d] / distance);
+                }
+            }
+        }
+        chunkMin[chunk] = localMin;
+    });
+    
+    minEdgeRate = *std::min_element(chunkMin.begin(), chunkMin.end());
+    if (std::isinf(minEdgeRate)) {
+        minEdgeRate = 0.0; // No legal moves
+    }
+}
+
+void Terrain::updateEdgeCosts(int x0, int y0, int x1, int y1) {
+    // A cell's edits change its own moves and the moves into it
+    for (int cy = std::max(0, y0 - 1); cy <= std::min(height - 1, y1 + 1); cy++) {
+        for (int cx = std::max(0, x0 - 1); cx <= std::min(width - 1, x1 + 1); cx++) {
+            DirectionalCosts& costs = edgeCosts[index(cx, cy)];
+            for (int d = 0; d < DIRECTION_COUNT; d++) {
+                costs.cost[d] = computeEdgeCost(cx, cy, d);
+                double distance = (DIRECTION_DX[d] != 0 && DIRECTION_DY[d] != 0) ? std::sqrt(2.0) : 1.0;
+                minEdgeRate = std::min(minEdgeRate, costs.cost[d] / distance);
+            }
+        }
+    }
+}
+
+void Terrain::setWindVector(int x, int y, float wx, float wy) {
+    if (!isValidPosition(Point(x, y))) return;
+    
+    if (!hasWindField()) {
+        windField.allocate(cellCount(), WindVector{0.0f, 0.0f});
+        windField[index(x, y)] = WindVector{wx, wy};
+        rebuildEdgeCosts();
+    } else {
+        windField[index(x, y)] = WindVector{wx, wy};
+        updateEdgeCosts(x, y);
+    }
+    markChanged(x, y, x, y);
+}
+
+WindVector Terrain::getWindVector(int x, int y) const {
+    if (!hasWindField() || !isValidPosition(Point(x, y))) {
+        return WindVector{0.0f, 0.0f};
+    }
+    return windField[index(x, y)];
+}
+
+void Terrain::setWindField(const WindVector* rowMajor) {
+    if (!hasWindField()) {
+        windField.allocate(cellCount(), WindVector{0.0f, 0.0f});
+    }
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            windField[index(x, y)] = rowMajor[static_cast<size_t>(y) * width + x];
+        }
+    }
+    rebuildEdgeCosts();
+    markChanged(0, 0, width - 1, height - 1);
+}
+
+void Terrain::clearWindField() {
+    if (!hasWindField()) return;
+    windField = TerrainLayer<WindVector>();
+    edgeCosts = TerrainLayer<DirectionalCosts>();
+    minEdgeRate = 0.0;
+    markChanged(0, 0, width - 1, height - 1);
 }
 
 void Terrain::setTerrain(int x, int y, TerrainType type) {
     if (isValidPosition(Point(x, y))) {
-        grid[y][x] = type;
+        size_t i = index(x, y);
+        if (encoding == CellEncoding::FULL) {
+            grid[i] = type;
+        } else {
+            packedCells[i] = (packedCells[i] & ~0xFu) | (static_cast<uint32_t>(type) & 0xF);
+        }
+        updateCellCost(i);
+        if (hasWindField()) updateEdgeCosts(x, y);
+        markChanged(x, y, x, y);
     }
 }
 
 TerrainType Terrain::getTerrain(int x, int y) const {
     if (isValidPosition(Point(x, y))) {
-        return grid[y][x];
+        return cellType(index(x, y));
     }
     return TerrainType::OBSTACLE;
 }
 
 void Terrain::setElevation(int x, int y, double elevation) {
     if (isValidPosition(Point(x, y))) {
-        elevationMap[y][x] = elevation;
+        size_t i = index(x, y);
+        if (encoding == CellEncoding::FULL) {
+            elevationMap[i] = elevation;
+        } else {
+            uint32_t cell = packedCells[i];
+            packedCells[i] = packCell(packedType(cell), elevation, packedWind(cell));
+        }
+        updateCellCost(i);
+        if (hasWindField()) updateEdgeCosts(x, y);
+        markChanged(x, y, x, y);
     }
 }
 
 double Terrain::getElevation(int x, int y) const {
     if (isValidPosition(Point(x, y))) {
-        return elevationMap[y][x];
+        size_t i = index(x, y);
+        return encoding == CellEncoding::FULL ? elevationMap[i] : packedElevation(packedCells[i]);
     }
     return 0.0;
 }
 
 void Terrain::setWindResistance(int x, int y, double resistance) {
     if (isValidPosition(Point(x, y))) {
-        windResistance[y][x] = resistance;
+        size_t i = index(x, y);
+        if (encoding == CellEncoding::FULL) {
+            windResistance[i] = resistance;
+        } else {
+            uint32_t cell = packedCells[i];
+            packedCells[i] = packCell(packedType(cell), packedElevation(cell), resistance);
+        }
+        updateCellCost(i);
+        if (hasWindField()) updateEdgeCosts(x, y);
+        markChanged(x, y, x, y);
     }
 }
 
 double Terrain::getWindResistance(int x, int y) const {
     if (isValidPosition(Point(x, y))) {
-        return windResistance[y][x];
+        size_t i = index(x, y);
+        return encoding == CellEncoding::FULL ? windResistance[i] : packedWind(packedCells[i]);
     }
     return 0.0;
 }
@@ -61,7 +607,7 @@ bool Terrain::isValidPosition(const Point& pos) const {
 
 bool Terrain::isObstacle(const Point& pos) const {
     if (!isValidPosition(pos)) return true;
-    return grid[pos.y][pos.x] == TerrainType::OBSTACLE;
+    return cellType(index(pos.x, pos.y)) == TerrainType::OBSTACLE;
 }
 
 bool Terrain::isPassable(const Point& pos) const {
@@ -69,34 +615,8 @@ bool Terrain::isPassable(const Point& pos) const {
 }
 
 double Terrain::getMovementCost(const Point& pos) const {
-    if (!isValidPosition(pos)) return OBSTACLE_COST;
-    
-    double baseCost = NORMAL_COST;
-    TerrainType type = grid[pos.y][pos.x];
-    
-    switch (type) {
-        case TerrainType::NORMAL:
-            baseCost = NORMAL_COST;
-            break;
-        case TerrainType::HILL:
-            baseCost = HILL_COST;
-            break;
-        case TerrainType::WIND_ZONE:
-            baseCost = WIND_COST;
-            break;
-        case TerrainType::OBSTACLE:
-            return OBSTACLE_COST;
-        default:
-            baseCost = NORMAL_COST;
-    }
-    
-    // Add elevation cost
-    double elevationCost = elevationMap[pos.y][pos.x] * 0.5;
-    
-    // Add wind resistance
-    double windCost = windResistance[pos.y][pos.x] * 0.3;
-    
-    return baseCost + elevationCost + windCost;
+    if (!isValidPosition(pos)) return costProfile.obstacleCost;
+    return cellCost(index(pos.x, pos.y));
 }
 
 double Terrain::getHeuristicCost(const Point& from, const Point& to) const {
@@ -104,8 +624,8 @@ double Terrain::getHeuristicCost(const Point& from, const Point& to) const {
     double dx = std::abs(to.x - from.x);
     double dy = std::abs(to.y - from.y);
     
-    // Euclidean distance for more accurate heuristic
-    return std::sqrt(dx * dx + dy * dy);
+    // Euclidean distance scaled by the cheapest cell stays admissible
+    return std::sqrt(dx * dx + dy * dy) * minCellCost;
 }
 
 void Terrain::visualizeTerrain() const {
@@ -119,7 +639,7 @@ void Terrain::visualizeTerrain() const {
     for (int y = 0; y < height; y++) {
         std::cout << std::setw(2) << y;
         for (int x = 0; x < width; x++) {
-            std::cout << " " << getTerrainChar(grid[y][x]);
+            std::cout << " " << getTerrainChar(cellType(index(x, y)));
         }
         std::cout << "\n";
     }
@@ -159,7 +679,7 @@ void Terrain::visualizePath(const std::vector<Point>& path) const {
                 }
                 std::cout << " " << BRIGHT_GREEN << displayChar << RESET;
             } else {
-                displayChar = getTerrainChar(grid[y][x]);
+                displayChar = getTerrainChar(cellType(index(x, y)));
                 std::cout << " " << GREEN << displayChar << RESET;
             }
         }
@@ -175,6 +695,8 @@ char Terrain::getTerrainChar(TerrainType type) const {
         case TerrainType::WIND_ZONE: return 'W';
         case TerrainType::START: return 'S';
         case TerrainType::END: return 'D';
+        case TerrainType::ENERGY_STATION: return 'E';
+        case TerrainType::DANGER_ZONE: return 'X';
         default: return '?';
     }
 }
@@ -183,11 +705,8 @@ std::vector<Point> Terrain::getNeighbors(const Point& pos) const {
     std::vector<Point> neighbors;
     
     // 8-directional movement (including diagonals)
-    const int dx[] = {-1, -1, -1, 0, 0, 1, 1, 1};
-    const int dy[] = {-1, 0, 1, -1, 1, -1, 0, 1};
-    
-    for (int i = 0; i < 8; i++) {
-        Point neighbor(pos.x + dx[i], pos.y + dy[i]);
+    for (int i = 0; i < DIRECTION_COUNT; i++) {
+        Point neighbor(pos.x + DIRECTION_DX[i], pos.y + DIRECTION_DY[i]);
         if (isPassable(neighbor)) {
             neighbors.push_back(neighbor);
         }
@@ -198,27 +717,53 @@ std::vector<Point> Terrain::getNeighbors(const Point& pos) const {
 
 void Terrain::generateRandomTerrain(double obstacleProb, double hillProb, double windProb) {
     std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 1.0);
+    uint64_t seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    generateRandomTerrain(obstacleProb, hillProb, windProb, seed);
+}
+
+void Terrain::generateRandomTerrain(double obstacleProb, double hillProb, double windProb,
+                                    uint64_t seed, unsigned threads) {
+    if (threads == 0) {
+        threads = static_cast<size_t>(width) * height >= (1u << 20) ? defaultThreadCount() : 1;
+    }
     
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            double roll = dis(gen);
-            
-            if (roll < obstacleProb) {
-                setTerrain(x, y, TerrainType::OBSTACLE);
-            } else if (roll < obstacleProb + hillProb) {
-                setTerrain(x, y, TerrainType::HILL);
-                setElevation(x, y, dis(gen) * 5.0); // Random elevation 0-5
-            } else if (roll < obstacleProb + hillProb + windProb) {
-                setTerrain(x, y, TerrainType::WIND_ZONE);
-                setWindResistance(x, y, dis(gen) * 3.0); // Random wind resistance 0-3
-            } else {
-                setTerrain(x, y, TerrainType::NORMAL);
-                setElevation(x, y, dis(gen) * 2.0); // Small elevation variation
+    parallelFor(0, height, threads, [&](size_t begin, size_t end, unsigned) {
+        for (int y = static_cast<int>(begin); y < static_cast<int>(end); y++) {
+            // One stream per row, two draws per cell
+            CounterRng rng(seed, static_cast<uint64_t>(y));
+            for (int x = 0; x < width; x++) {
+                double roll = rng.nextDouble();
+                double amount = rng.nextDouble();
+                
+                TerrainType type = TerrainType::NORMAL;
+                double elevation = 0.0;
+                double wind = 0.0;
+                if (roll < obstacleProb) {
+                    type = TerrainType::OBSTACLE;
+                } else if (roll < obstacleProb + hillProb) {
+                    type = TerrainType::HILL;
+                    elevation = amount * 5.0; // Random elevation 0-5
+                } else if (roll < obstacleProb + hillProb + windProb) {
+                    type = TerrainType::WIND_ZONE;
+                    wind = amount * 3.0; // Random wind resistance 0-3
+                } else {
+                    elevation = amount * 2.0; // Small elevation variation
+                }
+                
+                size_t i = index(x, y);
+                if (encoding == CellEncoding::FULL) {
+                    grid[i] = type;
+                    elevationMap[i] = elevation;
+                    windResistance[i] = wind;
+                } else {
+                    packedCells[i] = packCell(type, elevation, wind);
+                }
             }
         }
-    }
+    });
+    
+    rebuildCostLayer();
+    markChanged(0, 0, width - 1, height - 1);
 }
 
 void Terrain::addObstacle(const Point& pos) {
@@ -234,3 +779,252 @@ void Terrain::addWindZone(const Point& pos) {
     setTerrain(pos.x, pos.y, TerrainType::WIND_ZONE);
     setWindResistance(pos.x, pos.y, 2.0);
 }
+
+void Terrain::addEnergyStation(const Point& pos) {
+    setTerrain(pos.x, pos.y, TerrainType::ENERGY_STATION);
+}
+
+std::vector<Point> Terrain::getEnergyStations() const {
+    std::vector<Point> stations;
+    const bool rowMajor = layout == CellLayout::ROW_MAJOR && encoding == CellEncoding::FULL;
+    for (int y = 0; y < height; y++) {
+        if (rowMajor) {
+            // Stations are sparse: scan each row with std::find
+            const TerrainType* row = grid.data() + static_cast<size_t>(y) * width;
+            const TerrainType* end = row + width;
+            for (const TerrainType* at = std::find(row, end, TerrainType::ENERGY_STATION); at != end;
+                 at = std::find(at + 1, end, TerrainType::ENERGY_STATION)) {
+                stations.push_back(Point(static_cast<int>(at - row), y));
+            }
+            continue;
+        }
+        for (int x = 0; x < width; x++) {
+            if (cellType(index(x, y)) == TerrainType::ENERGY_STATION) {
+                stations.push_back(Point(x, y));
+            }
+        }
+    }
+    return stations;
+}
+
+void Terrain::paintSpan(int y, int x0, int x1, const TerrainBrush& brush) {
+    const bool setType = brush.fields & TerrainBrush::TYPE;
+    const bool setElevation = brush.fields & TerrainBrush::ELEVATION;
+    const bool setWind = brush.fields & TerrainBrush::WIND;
+    
+    if (encoding == CellEncoding::PACKED) {
+        for (int x = x0; x <= x1; x++) {
+            size_t i = index(x, y);
+            uint32_t cell = packedCells[i];
+            packedCells[i] = packCell(setType ? brush.type : packedType(cell),
+                                      setElevation ? brush.elevation : packedElevation(cell),
+                                      setWind ? brush.wind : packedWind(cell));
+            updateCellCost(i);
+        }
+        return;
+    }
+    
+    if (layout == CellLayout::ROW_MAJOR) {
+        // The span is contiguous in every layer
+        size_t first = index(x0, y);
+        size_t count = static_cast<size_t>(x1 - x0) + 1;
+        if (setType) std::fill_n(grid.data() + first, count, brush.type);
+        if (setElevation) std::fill_n(elevationMap.data() + first, count, brush.elevation);
+        if (setWind) std::fill_n(windResistance.data() + first, count, brush.wind);
+        
+        // Obstacles and fully specified brushes give the whole span one cost
+        if (setType && (brush.type == TerrainType::OBSTACLE || (setElevation && setWind))) {
+            std::fill_n(costLayer.data() + first, count, costProfile.cellCost(brush.type, brush.elevation, brush.wind));
+            updateCellCost(first);
+            return;
+        }
+        const TerrainType* types = grid.data();
+        const double* elevation = elevationMap.data();
+        const double* wind = windResistance.data();
+        double* cost = costLayer.data();
+        for (size_t i = first; i < first + count; i++) {
+            cost[i] = costProfile.cellCost(types[i], elevation[i], wind[i]);
+            if (types[i] != TerrainType::OBSTACLE) minCellCost = std::min(minCellCost, cost[i]);
+        }
+        return;
+    }
+    
+    for (int x = x0; x <= x1; x++) {
+        size_t i = index(x, y);
+        if (setType) grid[i] = brush.type;
+        if (setElevation) elevationMap[i] = brush.elevation;
+        if (setWind) windResistance[i] = brush.wind;
+        updateCellCost(i);
+    }
+}
+
+void Terrain::fillRect(int x0, int y0, int x1, int y1, const TerrainBrush& brush) {
+    if (x0 > x1) std::swap(x0, x1);
+    if (y0 > y1) std::swap(y0, y1);
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, width - 1);
+    y1 = std::min(y1, height - 1);
+    if (x0 > x1 || y0 > y1 || brush.fields == 0) return;
+    
+    for (int y = y0; y <= y1; y++) {
+        paintSpan(y, x0, x1, brush);
+    }
+    if (hasWindField()) updateEdgeCosts(x0, y0, x1, y1);
+    markChanged(x0, y0, x1, y1);
+}
+
+void Terrain::fillCircle(const Point& centre, double radius, const TerrainBrush& brush) {
+    if (!(radius >= 0.0) || brush.fields == 0) return;
+    
+    int reach = static_cast<int>(std::floor(radius));
+    int y0 = std::max(centre.y - reach, 0);
+    int y1 = std::min(centre.y + reach, height - 1);
+    int boxX0 = width, boxX1 = -1;
+    
+    for (int y = y0; y <= y1; y++) {
+        double dy = y - centre.y;
+        int half = static_cast<int>(std::floor(std::sqrt(radius * radius - dy * dy)));
+        int x0 = std::max(centre.x - half, 0);
+        int x1 = std::min(centre.x + half, width - 1);
+        if (x0 > x1) continue;
+        paintSpan(y, x0, x1, brush);
+        boxX0 = std::min(boxX0, x0);
+        boxX1 = std::max(boxX1, x1);
+    }
+    if (boxX0 > boxX1) return;
+    
+    if (hasWindField()) updateEdgeCosts(boxX0, y0, boxX1, y1);
+    markChanged(boxX0, y0, boxX1, y1);
+}
+
+void Terrain::fillPolygon(const std::vector<Vertex>& vertices, const TerrainBrush& brush) {
+    if (vertices.size() < 3 || brush.fields == 0) return;
+    
+    double minY = vertices[0].y, maxY = vertices[0].y;
+    for (const Vertex& v : vertices) {
+        minY = std::min(minY, v.y);
+        maxY = std::max(maxY, v.y);
+    }
+    // Rows whose centre line y + 0.5 lies in [minY, maxY)
+    int y0 = std::max(0, static_cast<int>(std::ceil(minY - 0.5)));
+    int y1 = std::min(height - 1, static_cast<int>(std::ceil(maxY - 0.5)) - 1);
+    
+    std::vector<double> crossings;
+    int boxX0 = width, boxX1 = -1, boxY0 = height, boxY1 = -1;
+    
+    for (int y = y0; y <= y1; y++) {
+        // Half-open edges: a vertex on the scanline counts for one edge only
+        double scan = y + 0.5;
+        crossings.clear();
+        for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+            const Vertex& a = vertices[j];
+            const Vertex& b = vertices[i];
+            if ((a.y <= scan) != (b.y <= scan)) {
+                crossings.push_back(a.x + (scan - a.y) * (b.x - a.x) / (b.y - a.y));
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+        
+        // Cells whose centre x + 0.5 lies in [left, right)
+        for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+            int x0 = std::max(0, static_cast<int>(std::ceil(crossings[k] - 0.5)));
+            int x1 = std::min(width - 1, static_cast<int>(std::ceil(crossings[k + 1] - 0.5)) - 1);
+            if (x0 > x1) continue;
+            paintSpan(y, x0, x1, brush);
+            boxX0 = std::min(boxX0, x0);
+            boxX1 = std::max(boxX1, x1);
+            boxY0 = std::min(boxY0, y);
+            boxY1 = std::max(boxY1, y);
+        }
+    }
+    if (boxX0 > boxX1) return;
+    
+    if (hasWindField()) updateEdgeCosts(boxX0, boxY0, boxX1, boxY1);
+    markChanged(boxX0, boxY0, boxX1, boxY1);
+}
+
+void Terrain::updateRegionSums() const {
+    const size_t stride = static_cast<size_t>(width) + 1;
+    const size_t entries = stride * (static_cast<size_t>(height) + 1);
+    if (costSums.size() != entries) {
+        // Row 0 and column 0 stay zero
+        costSums.assign(entries, 0.0);
+        obstacleSums.assign(entries, 0);
+        sumsStaleX = sumsStaleY = 0;
+    }
+    if (sumsStaleX >= width || sumsStaleY >= height) return;
+    
+    // Only entries (X, Y) with X > sumsStaleX and Y > sumsStaleY cover an
+    // edited cell. First each stale row gets its prefix sums, continuing
+    // from the still-valid entry at column sumsStaleX...
+    const int firstX = std::max(0, sumsStaleX);
+    const int firstY = std::max(0, sumsStaleY);
+    unsigned threads = entries >= (1u << 22) ? defaultThreadCount() : 1;
+    
+    parallelFor(firstY, height, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t y = begin; y < end; y++) {
+            double* costRow = costSums.data() + (y + 1) * stride;
+            uint32_t* obstacleRow = obstacleSums.data() + (y + 1) * stride;
+            double cost = costRow[firstX] - costRow[firstX - static_cast<long>(stride)];
+            uint32_t obstacles = obstacleRow[firstX] - obstacleRow[firstX - static_cast<long>(stride)];
+            for (int x = firstX; x < width; x++) {
+                size_t i = index(x, static_cast<int>(y));
+                cost += cellCost(i);
+                obstacles += cellType(i) == TerrainType::OBSTACLE;
+                costRow[x + 1] = cost;
+                obstacleRow[x + 1] = obstacles;
+            }
+        }
+    });
+    
+    // ...then the rows are accumulated downwards, a band of columns per
+    // worker so the inner loop runs along contiguous entries
+    const size_t band = 512;
+    size_t columns = static_cast<size_t>(width - firstX);
+    parallelFor(0, (columns + band - 1) / band, threads, [&](size_t first, size_t last, unsigned) {
+        size_t x0 = firstX + 1 + first * band;
+        size_t x1 = std::min(firstX + 1 + last * band, stride);
+        for (size_t y = firstY + 1; y <= static_cast<size_t>(height); y++) {
+            double* costRow = costSums.data() + y * stride;
+            const double* costAbove = costRow - stride;
+            uint32_t* obstacleRow = obstacleSums.data() + y * stride;
+            const uint32_t* obstacleAbove = obstacleRow - stride;
+            for (size_t x = x0; x < x1; x++) {
+                costRow[x] += costAbove[x];
+                obstacleRow[x] += obstacleAbove[x];
+            }
+        }
+    });
+    
+    sumsStaleX = width;
+    sumsStaleY = height;
+}
+
+double Terrain::regionCost(int x0, int y0, int x1, int y1) const {
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, width - 1);
+    y1 = std::min(y1, height - 1);
+    if (x0 > x1 || y0 > y1) return 0.0;
+    
+    updateRegionSums();
+    const size_t stride = static_cast<size_t>(width) + 1;
+    const double* top = costSums.data() + static_cast<size_t>(y0) * stride;
+    const double* bottom = costSums.data() + static_cast<size_t>(y1 + 1) * stride;
+    return (bottom[x1 + 1] - bottom[x0]) - (top[x1 + 1] - top[x0]);
+}
+
+size_t Terrain::regionObstacleCount(int x0, int y0, int x1, int y1) const {
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, width - 1);
+    y1 = std::min(y1, height - 1);
+    if (x0 > x1 || y0 > y1) return 0;
+    
+    updateRegionSums();
+    const size_t stride = static_cast<size_t>(width) + 1;
+    const uint32_t* top = obstacleSums.data() + static_cast<size_t>(y0) * stride;
+    const uint32_t* bottom = obstacleSums.data() + static_cast<size_t>(y1 + 1) * stride;
+    return (bottom[x1 + 1] - bottom[x0]) - (top[x1 + 1] - top[x0]);
+}
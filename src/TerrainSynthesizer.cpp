@@ -0,0 +1,182 @@
+#include "../include/TerrainSynthesizer.h"
+#include "../include/CounterRng.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Per-octave constants shared by every row: the lattice column of each x is
+// constant over a span, and the smoothed weight inside the span only
+// depends on x
+struct OctaveTable {
+    double frequency;
+    float amplitude;
+    std::vector<float> weight;   // Smoothstep of the fractional lattice x
+    std::vector<int> spanStart;  // First x of each lattice column, plus width
+};
+
+float smooth(float t) {
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// Lattice value in [0, 1)
+float latticeValue(const CounterRng& rng, int column, int row) {
+    uint64_t position = (static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32) | static_cast<uint32_t>(column);
+    return static_cast<float>(rng.at(position) >> 40) * (1.0f / 16777216.0f);
+}
+
+// out[i] += base + slope * weight[i]
+void accumulateSpan(float* out, const float* weight, int count, float base, float slope) {
+    int i = 0;
+#if defined(__SSE2__)
+    __m128 vbase = _mm_set1_ps(base);
+    __m128 vslope = _mm_set1_ps(slope);
+    for (; i + 4 <= count; i += 4) {
+        __m128 w = _mm_loadu_ps(weight + i);
+        __m128 o = _mm_loadu_ps(out + i);
+        _mm_storeu_ps(out + i, _mm_add_ps(o, _mm_add_ps(vbase, _mm_mul_ps(vslope, w))));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] += base + slope * weight[i];
+    }
+}
+
+// One row of fractal noise, normalized to [0, 1)
+void noiseRow(const std::vector<OctaveTable>& tables, uint64_t seed, int field, int y,
+              std::vector<float>& lattice, float* out, int width) {
+    std::fill(out, out + width, 0.0f);
+    float total = 0.0f;
+
+    for (size_t o = 0; o < tables.size(); o++) {
+        const OctaveTable& table = tables[o];
+        CounterRng rng(seed, static_cast<uint64_t>(field) * 64 + o);
+
+        // Blend the two lattice rows around y, once per column
+        double ly = y * table.frequency;
+        int row = static_cast<int>(std::floor(ly));
+        float sy = smooth(static_cast<float>(ly - row));
+        size_t columns = table.spanStart.size(); // One more than the spans
+        lattice.resize(columns);
+        for (size_t k = 0; k < columns; k++) {
+            float top = latticeValue(rng, static_cast<int>(k), row);
+            float bottom = latticeValue(rng, static_cast<int>(k), row + 1);
+            lattice[k] = top + (bottom - top) * sy;
+        }
+
+        const float amplitude = table.amplitude;
+        for (size_t k = 0; k + 1 < columns; k++) {
+            int x0 = table.spanStart[k];
+            int x1 = table.spanStart[k + 1];
+            accumulateSpan(out + x0, table.weight.data() + x0, x1 - x0,
+                           lattice[k] * amplitude, (lattice[k + 1] - lattice[k]) * amplitude);
+        }
+        total += amplitude;
+    }
+
+    const float scale = 1.0f / total;
+    for (int x = 0; x < width; x++) {
+        out[x] = std::min(out[x] * scale, 0.99999994f);
+    }
+}
+
+}
+
+TerrainSynthesizer::TerrainSynthesizer(const NoiseSettings& noiseSettings) : settings(noiseSettings) {
+    if (settings.octaves < 1 || settings.octaves > 16 || !(settings.featureSize >= 1.0) ||
+        !(settings.lacunarity > 0.0)) {
+        throw std::runtime_error("Invalid noise settings");
+    }
+}
+
+Terrain TerrainSynthesizer::generate(int width, int height, uint64_t seed, CellEncoding encoding,
+                                     const CostProfile& profile, unsigned threads) const {
+    Terrain terrain(width, height, profile, encoding);
+    fill(terrain, seed, threads);
+    return terrain;
+}
+
+void TerrainSynthesizer::fill(Terrain& terrain, uint64_t seed, unsigned threads) const {
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+    if (width <= 0 || height <= 0) return;
+
+    std::vector<OctaveTable> tables(settings.octaves);
+    double frequency = 1.0 / settings.featureSize;
+    double amplitude = 1.0;
+    for (OctaveTable& table : tables) {
+        table.frequency = frequency;
+        table.amplitude = static_cast<float>(amplitude);
+        table.weight.resize(width);
+        for (int x = 0; x < width; x++) {
+            double lx = x * frequency;
+            int column = static_cast<int>(std::floor(lx));
+            table.weight[x] = smooth(static_cast<float>(lx - column));
+            while (static_cast<int>(table.spanStart.size()) <= column) {
+                table.spanStart.push_back(x);
+            }
+        }
+        table.spanStart.push_back(width);
+        frequency *= settings.lacunarity;
+        amplitude *= settings.persistence;
+    }
+
+    if (threads == 0) {
+        threads = static_cast<size_t>(width) * height >= (1u << 20) ? defaultThreadCount() : 1;
+    }
+
+    const double rise = 1.0 / std::max(1e-9, 1.0 - settings.baseLevel);
+    const double gust = 1.0 / std::max(1e-9, 1.0 - settings.windLevel);
+    const double maxElevation = std::min(settings.maxElevation, Terrain::PACKED_VALUE_MAX);
+    const double maxWind = std::min(settings.maxWind, Terrain::PACKED_VALUE_MAX);
+
+    parallelFor(0, height, threads, [&](size_t begin, size_t end, unsigned) {
+        std::vector<float> elevationNoise(width);
+        std::vector<float> windNoise(width);
+        std::vector<float> lattice;
+
+        for (int y = static_cast<int>(begin); y < static_cast<int>(end); y++) {
+            noiseRow(tables, seed, 0, y, lattice, elevationNoise.data(), width);
+            noiseRow(tables, seed, 1, y, lattice, windNoise.data(), width);
+
+            for (int x = 0; x < width; x++) {
+                double e = elevationNoise[x];
+                if (settings.ridged) {
+                    e = 1.0 - std::fabs(2.0 * e - 1.0);
+                }
+                double w = windNoise[x];
+
+                TerrainType type = TerrainType::NORMAL;
+                double elevation = std::max(0.0, e - settings.baseLevel) * rise * maxElevation;
+                double wind = 0.0;
+                if (e >= settings.obstacleLevel) {
+                    type = TerrainType::OBSTACLE;
+                } else if (e >= settings.hillLevel) {
+                    type = TerrainType::HILL;
+                } else if (w >= settings.windLevel) {
+                    type = TerrainType::WIND_ZONE;
+                    wind = (w - settings.windLevel) * gust * maxWind;
+                }
+
+                size_t i = terrain.index(x, y);
+                if (terrain.encoding == CellEncoding::FULL) {
+                    terrain.grid[i] = type;
+                    terrain.elevationMap[i] = elevation;
+                    terrain.windResistance[i] = wind;
+                } else {
+                    terrain.packedCells[i] = Terrain::packCell(type, elevation, wind);
+                }
+            }
+        }
+    });
+
+    terrain.rebuildCostLayer();
+    terrain.markChanged(0, 0, width - 1, height - 1);
+}
@@ -0,0 +1,302 @@
+#include "../include/VisibilityPlanner.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+// Walk the cells a centre-to-centre segment passes through, in order,
+// calling visit(x, y) for each cell after a; stops early when visit returns
+// false. A segment through a shared vertex steps diagonally.
+template <typename Visit>
+static bool traceSegment(const Point& a, const Point& b, Visit visit) {
+    int nx = std::abs(b.x - a.x);
+    int ny = std::abs(b.y - a.y);
+    int sx = b.x > a.x ? 1 : -1;
+    int sy = b.y > a.y ? 1 : -1;
+    int x = a.x, y = a.y;
+
+    for (int ix = 0, iy = 0; ix < nx || iy < ny;) {
+        // Compare where the segment crosses the next vertical and horizontal cell edges
+        long long decision = static_cast<long long>(1 + 2 * ix) * ny - static_cast<long long>(1 + 2 * iy) * nx;
+        if (decision == 0) {
+            x += sx;
+            y += sy;
+            ix++;
+            iy++;
+        } else if (decision < 0) {
+            x += sx;
+            ix++;
+        } else {
+            y += sy;
+            iy++;
+        }
+        if (!visit(x, y)) return false;
+    }
+    return true;
+}
+
+static double segmentLength(const Point& a, const Point& b) {
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+VisibilityPlanner::VisibilityPlanner(const Terrain& terrainRef)
+    : terrain(terrainRef), applicable(false), uniformCost(0.0), builtVersion(0), built(false),
+      lastPathCost(0.0) {}
+
+bool VisibilityPlanner::lineOfSight(const Point& a, const Point& b) const {
+    if (terrain.isObstacle(a) || terrain.isObstacle(b)) return false;
+    return traceSegment(a, b, [this](int x, int y) {
+        return !terrain.isObstacle(Point(x, y));
+    });
+}
+
+bool VisibilityPlanner::clearSegment(const Point& a, const Point& b) const {
+    const int width = terrain.getWidth();
+    const uint8_t* cells = blockedCells.data();
+    return traceSegment(a, b, [cells, width](int x, int y) {
+        return !cells[static_cast<size_t>(y) * width + x];
+    });
+}
+
+std::vector<Point> VisibilityPlanner::expandPath(const std::vector<Point>& waypoints) {
+    std::vector<Point> path;
+    if (waypoints.empty()) return path;
+
+    path.push_back(waypoints[0]);
+    for (size_t i = 1; i < waypoints.size(); i++) {
+        traceSegment(waypoints[i - 1], waypoints[i], [&path](int x, int y) {
+            path.push_back(Point(x, y));
+            return true;
+        });
+    }
+    return path;
+}
+
+bool VisibilityPlanner::isTangent(size_t corner, const Point& other) const {
+    if (cornerMask[corner] == ANY_DIRECTION) return true;
+
+    // In doubled coordinates around the corner cell's centre, the obstacle
+    // square diagonal (dx, dy) spans (2dx +- 1, 2dy +- 1). The line is
+    // tangent when no square corner lies strictly on each side of it.
+    long long vx = other.x - corners[corner].x;
+    long long vy = other.y - corners[corner].y;
+    for (int d = 0; d < 4; d++) {
+        if (!(cornerMask[corner] & (1 << d))) continue;
+        int dx = d & 1 ? 1 : -1;
+        int dy = d & 2 ? 1 : -1;
+        bool left = false, right = false;
+        for (int c = 0; c < 4; c++) {
+            long long px = 2 * dx + (c & 1 ? 1 : -1);
+            long long py = 2 * dy + (c & 2 ? 1 : -1);
+            long long cross = vx * py - vy * px;
+            left |= cross > 0;
+            right |= cross < 0;
+        }
+        if (!(left && right)) return true;
+    }
+    return false;
+}
+
+void VisibilityPlanner::ensureBuilt() {
+    if (!built || builtVersion != terrain.getVersion()) {
+        build();
+    }
+}
+
+bool VisibilityPlanner::isApplicable() {
+    ensureBuilt();
+    return applicable;
+}
+
+void VisibilityPlanner::build() {
+    const int width = terrain.getWidth();
+    const int height = terrain.getHeight();
+
+    built = true;
+    builtVersion = terrain.getVersion();
+    blockedCells.clear();
+    corners.clear();
+    cornerMask.clear();
+    edgeStart.assign(1, 0);
+    edgeTarget.clear();
+    edgeLength.clear();
+
+    // Straight segments are only optimal when every passable cell costs the same
+    applicable = true;
+    bool anyPassable = false;
+    for (int y = 0; y < height && applicable; y++) {
+        for (int x = 0; x < width; x++) {
+            size_t i = terrain.cellIndex(x, y);
+            if (terrain.cellType(i) == TerrainType::OBSTACLE) continue;
+            if (!anyPassable) {
+                uniformCost = terrain.cellCost(i);
+                anyPassable = true;
+            } else if (terrain.cellCost(i) != uniformCost) {
+                applicable = false;
+                break;
+            }
+        }
+    }
+    if (!applicable) return;
+
+    // Bend cells: a free cell with an obstacle diagonally across and free
+    // cells on both sides of that diagonal (a convex corner), or with two
+    // obstacles beside a free diagonal (a gap grid moves can squeeze through)
+    blockedCells.assign(static_cast<size_t>(width) * height, 0);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            blockedCells[static_cast<size_t>(y) * width + x] = terrain.isObstacle(Point(x, y));
+        }
+    }
+    auto blocked = [this, width, height](int x, int y) {
+        return x >= 0 && y >= 0 && x < width && y < height && blockedCells[static_cast<size_t>(y) * width + x];
+    };
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (blocked(x, y)) continue;
+            uint8_t convex = 0;
+            bool gap = false;
+            for (int d = 0; d < 4; d++) {
+                int dx = d & 1 ? 1 : -1;
+                int dy = d & 2 ? 1 : -1;
+                bool sideA = blocked(x + dx, y);
+                bool sideB = blocked(x, y + dy);
+                if (blocked(x + dx, y + dy)) {
+                    if (!sideA && !sideB) convex |= 1 << d;
+                } else if (sideA && sideB) {
+                    gap = true;
+                }
+            }
+            if (convex || gap) {
+                corners.push_back(Point(x, y));
+                cornerMask.push_back(gap ? ANY_DIRECTION : convex);
+            }
+        }
+    }
+
+    // All-pairs line of sight among taut pairs, split across threads by first corner
+    size_t count = corners.size();
+    std::vector<std::vector<uint32_t>> visible(count);
+    unsigned threads = count >= 256 ? defaultThreadCount() : 1;
+    parallelFor(0, count, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+            for (size_t j = i + 1; j < count; j++) {
+                if (isTangent(i, corners[j]) && isTangent(j, corners[i]) &&
+                    clearSegment(corners[i], corners[j])) {
+                    visible[i].push_back(static_cast<uint32_t>(j));
+                }
+            }
+        }
+    });
+
+    // Symmetric adjacency in compressed rows
+    std::vector<uint32_t> degree(count, 0);
+    for (size_t i = 0; i < count; i++) {
+        degree[i] += static_cast<uint32_t>(visible[i].size());
+        for (uint32_t j : visible[i]) degree[j]++;
+    }
+    edgeStart.assign(count + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        edgeStart[i + 1] = edgeStart[i] + degree[i];
+    }
+    edgeTarget.resize(edgeStart[count]);
+    edgeLength.resize(edgeStart[count]);
+
+    std::vector<uint32_t> fill(edgeStart.begin(), edgeStart.end() - 1);
+    for (size_t i = 0; i < count; i++) {
+        for (uint32_t j : visible[i]) {
+            double length = segmentLength(corners[i], corners[j]);
+            edgeTarget[fill[i]] = j;
+            edgeLength[fill[i]++] = length;
+            edgeTarget[fill[j]] = static_cast<uint32_t>(i);
+            edgeLength[fill[j]++] = length;
+        }
+    }
+}
+
+std::vector<Point> VisibilityPlanner::findPath(const Point& start, const Point& goal) {
+    ensureBuilt();
+    if (!applicable) {
+        throw std::runtime_error("Visibility planner needs uniform passable cell costs");
+    }
+
+    lastPathCost = 0.0;
+    if (!terrain.isPassable(start) || !terrain.isPassable(goal)) {
+        return std::vector<Point>();
+    }
+    if (start == goal) {
+        return std::vector<Point>(1, start);
+    }
+    if (clearSegment(start, goal)) {
+        lastPathCost = segmentLength(start, goal) * uniformCost;
+        return std::vector<Point>{start, goal};
+    }
+
+    // Corners are nodes 0..count-1, then start and goal
+    const uint32_t count = static_cast<uint32_t>(corners.size());
+    const uint32_t startNode = count;
+    const uint32_t goalNode = count + 1;
+    const uint32_t none = UINT32_MAX;
+
+    // Goal links are needed whenever a corner is settled, so find them up front
+    std::vector<double> toGoal(count, -1.0);
+    for (uint32_t i = 0; i < count; i++) {
+        if (isTangent(i, goal) && clearSegment(corners[i], goal)) {
+            toGoal[i] = segmentLength(corners[i], goal);
+        }
+    }
+
+    std::vector<double> distance(count + 2, std::numeric_limits<double>::infinity());
+    std::vector<uint32_t> parent(count + 2, none);
+    typedef std::pair<double, uint32_t> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+    auto relax = [&](uint32_t from, uint32_t to, double length) {
+        double d = distance[from] + length;
+        if (d < distance[to]) {
+            distance[to] = d;
+            parent[to] = from;
+            queue.push(QueueEntry(d, to));
+        }
+    };
+
+    distance[startNode] = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (isTangent(i, start) && clearSegment(start, corners[i])) {
+            relax(startNode, i, segmentLength(start, corners[i]));
+        }
+    }
+
+    while (!queue.empty()) {
+        QueueEntry top = queue.top();
+        queue.pop();
+        uint32_t node = top.second;
+        if (top.first > distance[node]) continue;
+        if (node == goalNode) break;
+
+        if (toGoal[node] >= 0.0) {
+            relax(node, goalNode, toGoal[node]);
+        }
+        for (uint32_t e = edgeStart[node]; e < edgeStart[node + 1]; e++) {
+            relax(node, edgeTarget[e], edgeLength[e]);
+        }
+    }
+
+    if (parent[goalNode] == none) {
+        return std::vector<Point>();
+    }
+
+    std::vector<Point> waypoints;
+    for (uint32_t node = goalNode; node != none; node = parent[node]) {
+        waypoints.push_back(node == startNode ? start : node == goalNode ? goal : corners[node]);
+    }
+    std::reverse(waypoints.begin(), waypoints.end());
+    lastPathCost = distance[goalNode] * uniformCost;
+    return waypoints;
+}
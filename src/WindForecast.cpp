@@ -0,0 +1,138 @@
+#include "../include/WindForecast.h"
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+WindForecast::WindForecast(int w, int h)
+    : width(w), height(h), published(std::make_shared<FrameSet>()), streaming(false) {
+    if (w <= 0 || h <= 0) {
+        throw std::runtime_error("Wind forecast needs a positive map size");
+    }
+}
+
+WindForecast::~WindForecast() {
+    if (streamThread.joinable()) {
+        streamThread.join();
+    }
+}
+
+WindForecast::Snapshot WindForecast::snapshot() const {
+    return std::atomic_load(&published);
+}
+
+void WindForecast::appendFrame(double time, std::vector<WindVector> field) {
+    if (field.size() != static_cast<size_t>(width) * height) {
+        throw std::runtime_error("Wind frame does not match the forecast size");
+    }
+    
+    std::shared_ptr<WindFrame> frame = std::make_shared<WindFrame>();
+    frame->time = time;
+    frame->field = std::move(field);
+    
+    // Build the next set from the current one (frames themselves are
+    // shared, not copied), then swap it in for new readers. Writers hold
+    // the lock from read to store so none of them drops another's frame.
+    std::lock_guard<std::mutex> lock(writeMutex);
+    Snapshot current = snapshot();
+    std::shared_ptr<FrameSet> next = std::make_shared<FrameSet>(*current);
+    auto slot = std::lower_bound(next->frames.begin(), next->frames.end(), time,
+        [](const std::shared_ptr<const WindFrame>& f, double t) { return f->time < t; });
+    if (slot != next->frames.end() && (*slot)->time == time) {
+        *slot = frame;
+    } else {
+        next->frames.insert(slot, frame);
+    }
+    std::atomic_store(&published, Snapshot(next));
+}
+
+std::vector<WindVector> WindForecast::readField(std::istream& in, double time) const {
+    std::vector<WindVector> field(static_cast<size_t>(width) * height);
+    for (WindVector& wind : field) {
+        if (!(in >> wind.x >> wind.y)) {
+            throw std::runtime_error("Truncated wind frame at time " + std::to_string(time));
+        }
+    }
+    return field;
+}
+
+size_t WindForecast::loadFrames(std::istream& in) {
+    size_t count = 0;
+    std::string keyword;
+    while (in >> keyword) {
+        double time;
+        if (keyword != "frame" || !(in >> time)) {
+            throw std::runtime_error("Expected 'frame <time>' in wind forecast");
+        }
+        appendFrame(time, readField(in, time));
+        count++;
+    }
+    return count;
+}
+
+void WindForecast::streamFile(const std::string& filename) {
+    waitForStream();
+    
+    std::shared_ptr<std::ifstream> file = std::make_shared<std::ifstream>(filename);
+    if (!file->is_open()) {
+        throw std::runtime_error("Cannot open wind forecast: " + filename);
+    }
+    
+    streamError = nullptr;
+    streaming = true;
+    streamThread = std::thread([this, file]() {
+        try {
+            loadFrames(*file);
+        } catch (...) {
+            streamError = std::current_exception();
+        }
+        streaming = false;
+    });
+}
+
+void WindForecast::waitForStream() {
+    if (streamThread.joinable()) {
+        streamThread.join();
+    }
+    if (streamError) {
+        std::exception_ptr error = streamError;
+        streamError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+WindForecast::Blend WindForecast::blendAt(const FrameSet& set, double time) {
+    const auto& frames = set.frames;
+    if (frames.empty()) {
+        return Blend{nullptr, nullptr, 0.0f};
+    }
+    if (time <= frames.front()->time) {
+        return Blend{frames.front().get(), frames.front().get(), 0.0f};
+    }
+    if (time >= frames.back()->time) {
+        return Blend{frames.back().get(), frames.back().get(), 0.0f};
+    }
+    
+    auto after = std::upper_bound(frames.begin(), frames.end(), time,
+        [](double t, const std::shared_ptr<const WindFrame>& f) { return t < f->time; });
+    const WindFrame* later = after->get();
+    const WindFrame* earlier = (after - 1)->get();
+    float weight = static_cast<float>((time - earlier->time) / (later->time - earlier->time));
+    return Blend{earlier, later, weight};
+}
+
+WindVector WindForecast::sample(int x, int y, double time) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return WindVector{0.0f, 0.0f};
+    }
+    Snapshot set = snapshot();
+    return sample(blendAt(*set, time), static_cast<size_t>(y) * width + x);
+}
+
+void WindForecast::sampleField(double time, std::vector<WindVector>& field) const {
+    Snapshot set = snapshot();
+    Blend blend = blendAt(*set, time);
+    field.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < field.size(); i++) {
+        field[i] = sample(blend, i);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <filesystem>
+
+// Minimal checks for the test programs under tests/: every failed CHECK
+// is reported and counted, and main returns testResult()
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition "\n"; \
+            testFailures()++;                                                         \
+        }                                                                             \
+    } while (0)
+
+inline int testResult(const char* name) {
+    if (testFailures() == 0) {
+        std::cout << name << ": passed\n";
+        return 0;
+    }
+    std::cout << name << ": " << testFailures() << " check(s) failed\n";
+    return 1;
+}
+
+// Write content to a file in the system temp directory and return its path
+inline std::string writeTempFile(const std::string& name, const std::string& content) {
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream file(path, std::ios::binary);
+    file << content;
+    return path;
+}
+
+#endif
@@ -0,0 +1,40 @@
+#include "../include/MapParser.h"
+#include "TestSupport.h"
+#include <cstdio>
+
+// loadConfiguration must warn and keep the defaults on bad values, never throw
+static void checkRejected(const std::string& costs) {
+    MapParser parser;
+    std::string path = writeTempFile("uav_test_config.json",
+                                     "{\"terrain_costs\": {" + costs + "}, \"map_generation\": {\"seed\": 42}}");
+    bool loaded = true;
+    try {
+        loaded = parser.loadConfiguration(path, false);
+    } catch (...) {
+        CHECK(!"loadConfiguration threw");
+    }
+    CHECK(!loaded);
+    CostProfile defaults;
+    CHECK(parser.getCostProfile().fingerprint() == defaults.fingerprint());
+    std::remove(path.c_str());
+}
+
+int main() {
+    checkRejected("\"hill_cost\": \"abc\"");
+    checkRejected("\"normal_cost\": -1");
+    checkRejected("\"danger_zone_cost\": 0");
+    checkRejected("\"elevation_factor\": -0.5");
+    checkRejected("\"min_wind_scale\": 0");
+    checkRejected("\"obstacle_cost\": 1e999");
+
+    // Valid values still apply, zero factors included
+    MapParser parser;
+    std::string path = writeTempFile("uav_test_config.json",
+                                     "{\"terrain_costs\": {\"hill_cost\": 4.5, \"elevation_factor\": 0}}");
+    CHECK(parser.loadConfiguration(path, false));
+    CHECK(parser.getCostProfile().getTypeCost(TerrainType::HILL) == 4.5);
+    CHECK(parser.getCostProfile().elevationFactor == 0.0);
+    std::remove(path.c_str());
+
+    return testResult("config");
+}
@@ -0,0 +1,28 @@
+#include "../include/Optimizer.h"
+#include "../include/TerrainSynthesizer.h"
+#include "TestSupport.h"
+
+// A budget of exactly the least energy must be enough, even though the
+// search sums that energy from the goal end and calculatePathEnergy from
+// the start, and the two can round differently
+int main() {
+    TerrainSynthesizer synthesizer;
+    for (uint64_t seed = 1; seed <= 4; seed++) {
+        Terrain terrain = synthesizer.generate(64, 48, seed);
+        Optimizer optimizer(terrain);
+        for (int i = 0; i < 12; i++) {
+            Point start(static_cast<int>((seed * 7 + i * 5) % 64), static_cast<int>((seed + i * 11) % 48));
+            Point goal(63 - start.x, 47 - start.y);
+            std::vector<Point> least = optimizer.findPathAStar(start, goal);
+            if (least.empty()) continue;
+            double budget = optimizer.calculatePathEnergy(least);
+
+            std::vector<Point> route = optimizer.findEnergyConstrainedPath(start, goal, budget);
+            CHECK(!route.empty());
+            if (route.empty()) continue;
+            CHECK(route.front() == start && route.back() == goal);
+            CHECK(optimizer.calculatePathEnergy(route) <= budget * (1.0 + 1e-9));
+        }
+    }
+    return testResult("energy_budget");
+}
@@ -0,0 +1,54 @@
+#include "../include/ClearanceField.h"
+#include "../include/RectDecomposition.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <utility>
+
+// Assigning a terrain must leave structures built on the target stale,
+// however the two versions compare
+int main() {
+    Terrain small(8, 8);
+    small.setTerrain(3, 3, TerrainType::OBSTACLE);
+    ClearanceField field(small);
+    RectDecomposition rects(small);
+    CHECK(field.isCurrent());
+    CHECK(rects.isCurrent());
+
+    // The source has seen more edits than the target, so copying its
+    // version alone would make the field look current
+    Terrain large(40, 30);
+    for (int x = 0; x < 20; x++) large.setTerrain(x, 10, TerrainType::OBSTACLE);
+    uint64_t before = std::max(small.getVersion(), large.getVersion());
+    small = large;
+    CHECK(small.getVersion() > before);
+    CHECK(!field.isCurrent());
+    CHECK(rects.isCurrent()); // Rebuilt on the whole-map notification
+    CHECK(rects.rectAt(39, 29) != RectDecomposition::NO_RECT);
+    CHECK(rects.rectAt(5, 10) == RectDecomposition::NO_RECT);
+
+    field.refresh();
+    CHECK(field.isCurrent());
+    CHECK(field.getClearance(5, 10) == 0.0f);
+    CHECK(field.getClearance(5, 13) == 3.0f);
+    CHECK(field.getClearance(39, 29) > 0.0f);
+
+    // Same with a source at a lower version, and by move
+    Terrain fresh(16, 16);
+    fresh.setTerrain(0, 0, TerrainType::OBSTACLE);
+    before = std::max(small.getVersion(), fresh.getVersion());
+    small = std::move(fresh);
+    CHECK(small.getVersion() > before);
+    CHECK(!field.isCurrent());
+    field.refresh();
+    CHECK(field.getClearance(3, 4) == 5.0f);
+    CHECK(rects.isCurrent());
+    CHECK(rects.rectAt(0, 0) == RectDecomposition::NO_RECT);
+    CHECK(rects.rectAt(20, 20) == RectDecomposition::NO_RECT);
+
+    // Copies never take the source's listeners
+    Terrain copy(small);
+    copy.setTerrain(5, 5, TerrainType::OBSTACLE);
+    CHECK(field.isCurrent());
+
+    return testResult("terrain_assign");
+}